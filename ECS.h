@@ -11,14 +11,27 @@
 #include <set>
 #include <unordered_set>
 #include <cassert>
-#include <queue>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <functional>
 #include <mutex>
+#include <new>
+#include <memory>
 #include <shared_mutex>
 #include <map>
 #include <ranges>
+#include <span>
+#include <tuple>
+#include <chrono>
+#include <cstddef>
+#include <limits>
 #include "robin_hood.h"
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace sy::utils
 {
 	/**
@@ -29,9 +42,9 @@ namespace sy::utils
 	{
 		unsigned int hash = 0;
 		unsigned int x = 0;
-		for (unsigned int idx = 0; idx < sizeof(str); ++idx)
+		for (; *str != '\0'; ++str)
 		{
-			hash = (hash << 4) + (*str);
+			hash = (hash << 4) + static_cast<unsigned char>(*str);
 			x = hash & 0xF0000000L;
 			if (x != 0)
 			{
@@ -54,6 +67,97 @@ namespace sy::utils
 
 		return adjustment;
 	}
+
+	/** Mix value into seed, order of combination matters. */
+	constexpr size_t CombineHash(const size_t seed, const size_t value) noexcept
+	{
+		return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+	}
+
+	/**
+	* Growable two-level bitset. Summary bit is set when corresponding word has at least one set bit,
+	* so lowest set bit can be found by scanning summary words(1 summary word covers 4096 bits).
+	*/
+	class HierarchicalBitset
+	{
+		using Word = uint64_t;
+		static constexpr size_t BITS_PER_WORD = std::numeric_limits<Word>::digits;
+
+	public:
+		static constexpr size_t NPOS = std::numeric_limits<size_t>::max();
+
+	public:
+		void Resize(const size_t newSize)
+		{
+			if (newSize < size)
+			{
+				for (size_t idx = newSize; idx < size; ++idx)
+				{
+					Reset(idx);
+				}
+			}
+
+			size = newSize;
+			words.resize((size + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+			summaryWords.resize((words.size() + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+		}
+
+		void Clear() noexcept
+		{
+			std::fill(words.begin(), words.end(), 0);
+			std::fill(summaryWords.begin(), summaryWords.end(), 0);
+		}
+
+		void Set(const size_t idx) noexcept
+		{
+			assert(idx < size);
+			const size_t wordIdx = idx / BITS_PER_WORD;
+			words[wordIdx] |= (Word(1) << (idx % BITS_PER_WORD));
+			summaryWords[wordIdx / BITS_PER_WORD] |= (Word(1) << (wordIdx % BITS_PER_WORD));
+		}
+
+		void Reset(const size_t idx) noexcept
+		{
+			assert(idx < size);
+			const size_t wordIdx = idx / BITS_PER_WORD;
+			Word& word = words[wordIdx];
+			word &= ~(Word(1) << (idx % BITS_PER_WORD));
+			if (word == 0)
+			{
+				summaryWords[wordIdx / BITS_PER_WORD] &= ~(Word(1) << (wordIdx % BITS_PER_WORD));
+			}
+		}
+
+		[[nodiscard]] bool Test(const size_t idx) const noexcept
+		{
+			assert(idx < size);
+			return (words[idx / BITS_PER_WORD] & (Word(1) << (idx % BITS_PER_WORD))) != 0;
+		}
+
+		/** Return index of lowest set bit, NPOS if there is no set bit. */
+		[[nodiscard]] size_t FindFirst() const noexcept
+		{
+			for (size_t summaryIdx = 0; summaryIdx < summaryWords.size(); ++summaryIdx)
+			{
+				const Word summaryWord = summaryWords[summaryIdx];
+				if (summaryWord != 0)
+				{
+					const size_t wordIdx = (summaryIdx * BITS_PER_WORD) + std::countr_zero(summaryWord);
+					return (wordIdx * BITS_PER_WORD) + std::countr_zero(words[wordIdx]);
+				}
+			}
+
+			return NPOS;
+		}
+
+		[[nodiscard]] size_t Size() const noexcept { return size; }
+
+	private:
+		std::vector<Word> words;
+		std::vector<Word> summaryWords;
+		size_t size = 0;
+
+	};
 }
 
 namespace sy
@@ -66,852 +170,4338 @@ namespace sy
 
 namespace sy
 {
+	/** Optional empty base of component, it has no virtual table so deriving it does not add any byte to rows. */
 	struct Component
 	{
-		virtual ~Component() = default;
 	};
 
+	/** Tag component is empty type which only marks archetype, it has no column and never constructed in chunk. Specialized by DeclareTagComponent. */
+	template <typename T>
+	constexpr bool IS_TAG_COMPONENT = false;
+
+	/** Stable hash of component type name, it identifies component type regardless of order of registration. Specialized by DeclareComponent. */
+	using ComponentHash = uint32_t;
+	constexpr ComponentHash INVALID_COMPONENT_HASH = 0;
+
+	template <typename T>
+	constexpr ComponentHash QueryComponentHash()
+	{
+		return INVALID_COMPONENT_HASH;
+	}
+
+	/**
+	* Any declared class type which is default constructible and destructible can be component, it does not need to derive Component.
+	* Lifecycle is dispatched through ComponentRegistry, so plain data component stays trivially copyable and its column can be copied as raw memory.
+	*/
 	template <typename T>
-	concept ComponentType = std::is_base_of_v<Component, T>;
+	concept ComponentType = std::is_class_v<T> && !std::is_const_v<T> && std::default_initializable<T> && std::destructible<T> &&
+		(QueryComponentHash<T>() != INVALID_COMPONENT_HASH || IS_TAG_COMPONENT<T> || std::is_base_of_v<Component, T>);
 
+	/** Handle of entity, it packs index of entity record(lower 32 bits) and generation of that record(upper 32 bits). */
 	enum class Entity : uint64_t {};
 	constexpr Entity INVALID_ENTITY_HANDLE = static_cast<Entity>(0);
-	constexpr bool USE_RANDOM_NUM_FOR_ENTITY_HANDLE = false;
-	inline Entity GenerateEntity()
+
+	using EntityIndex = uint32_t;
+	/** Generation of record is increased whenever its entity is destroyed, so handles of destroyed entities never match record again. */
+	using EntityGeneration = uint32_t;
+	/** Generation starts from 1, so valid handle never equals to INVALID_ENTITY_HANDLE. */
+	constexpr EntityGeneration FIRST_ENTITY_GENERATION = 1;
+	/** Generation of record whose index is not owned by any handle, it is reserved, pooled or never reached yet. */
+	constexpr EntityGeneration UNISSUED_ENTITY_GENERATION = 0;
+
+	[[nodiscard]] constexpr Entity MakeEntity(const EntityIndex index, const EntityGeneration generation) noexcept
 	{
-		using EntityUnderlyingType = std::underlying_type_t<Entity>;
-		if constexpr (USE_RANDOM_NUM_FOR_ENTITY_HANDLE)
-		{
-			static thread_local std::mt19937_64 generator(
-				std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		return static_cast<Entity>((static_cast<uint64_t>(generation) << 32) | index);
+	}
 
-			const std::uniform_int_distribution<EntityUnderlyingType> dist(std::numeric_limits<EntityUnderlyingType>::min() + 1, std::numeric_limits<EntityUnderlyingType>::max());
-			return static_cast<Entity>(dist(generator));
-		}
+	[[nodiscard]] constexpr EntityIndex IndexOf(const Entity entity) noexcept
+	{
+		return static_cast<EntityIndex>(static_cast<uint64_t>(entity));
+	}
 
-		static std::atomic<EntityUnderlyingType> handle = 1;
-		return static_cast<Entity>(handle++);
+	[[nodiscard]] constexpr EntityGeneration GenerationOf(const Entity entity) noexcept
+	{
+		return static_cast<EntityGeneration>(static_cast<uint64_t>(entity) >> 32);
 	}
 
+	/** Defined after ComponentArchive, entity records live in component archive. */
+	Entity GenerateEntity();
+	void GenerateEntities(std::span<Entity> entities);
+
+	/** Dense index of component type, assigned when type is queried at first time. */
 	using ComponentID = uint32_t;
-	constexpr ComponentID INVALID_COMPONENT_ID = 0;
+	constexpr ComponentID INVALID_COMPONENT_ID = std::numeric_limits<ComponentID>::max();
+	/** Upper bound of number of component types, archetype signature is bitset of this width. */
+	constexpr size_t MAX_NUM_OF_COMPONENTS = 256;
+
+	/** Defined after ComponentRegistry. */
+	template <ComponentType T>
+	ComponentID QueryComponentID();
 
 	template <ComponentType T>
-	constexpr ComponentID QueryComponentID()
+	ComponentID QueryComponentID(const T&)
 	{
-		return INVALID_COMPONENT_ID;
+		return QueryComponentID<T>();
 	}
 
-	template <ComponentType T>
-	constexpr ComponentID QueryComponentID(const T&)
+	/** Enableable component can be disabled and enabled again without moving owner entity to other archetype. Specialized by DeclareEnableableComponent. */
+	template <typename T>
+	constexpr bool IS_ENABLEABLE_COMPONENT = false;
+
+	/** Shared component is stored once per chunk list instead of per row, entities which share equal value are grouped into same chunks. Specialized by DeclareSharedComponent. */
+	template <typename T>
+	constexpr bool IS_SHARED_COMPONENT = false;
+
+	template <typename T>
+	concept SharedComponentType = ComponentType<T> && IS_SHARED_COMPONENT<T> && std::equality_comparable<T> && std::copy_constructible<T>;
+
+	/**
+	* Opt-in reflection of component fields, specialized by DeclareComponentFields.
+	* Declared fields of component are stored as separate sub-columns(SoA inside of chunk) instead of array of whole component objects.
+	* Undeclared fields are not stored at all, and component object never lives in chunk, so it can not be accessed through Get.
+	*/
+	template <typename T>
+	struct ComponentFields
+	{
+		static constexpr bool bIsDeclared = false;
+	};
+
+	template <typename T>
+	concept FieldSplitComponentType = ComponentType<T> && ComponentFields<T>::bIsDeclared;
+
+	template <typename T>
+	struct MemberPointerTraits;
+
+	template <typename Owner, typename Field>
+	struct MemberPointerTraits<Field Owner::*>
+	{
+		using OwnerType = Owner;
+		using FieldType = Field;
+	};
+
+	template <auto Member>
+	using FieldTypeOf = typename MemberPointerTraits<decltype(Member)>::FieldType;
+
+	template <auto Member>
+	using FieldOwnerOf = typename MemberPointerTraits<decltype(Member)>::OwnerType;
+
+	/** Index of member in declared fields of its owner component. */
+	template <auto Member>
+	consteval size_t FieldIndexOf()
+	{
+		constexpr auto members = ComponentFields<FieldOwnerOf<Member>>::Members;
+		return[&members]<size_t... Indices>(std::index_sequence<Indices...>)
+		{
+			size_t fieldIndex = sizeof...(Indices);
+			([&fieldIndex, &members]()
+				{
+					if constexpr (std::is_same_v<std::remove_cvref_t<decltype(std::get<Indices>(members))>, decltype(Member)>)
+					{
+						fieldIndex = (fieldIndex == sizeof...(Indices) && std::get<Indices>(members) == Member) ? Indices : fieldIndex;
+					}
+				}(), ...);
+			return fieldIndex;
+		}(std::make_index_sequence<std::tuple_size_v<decltype(members)>>{});
+	}
+
+	struct FieldInfo
+	{
+		size_t Offset = 0;
+		size_t Size = 0;
+		size_t Alignment = 1;
+	};
+
+	template <FieldSplitComponentType T>
+	std::vector<FieldInfo> GenerateFieldInfos()
 	{
-		return QueryComponentID<T>;
+		/** Only address of fields are used, object is never constructed. */
+		union Storage
+		{
+			Storage() noexcept {}
+			~Storage() {}
+			T Object;
+		};
+
+		static Storage storage;
+		std::vector<FieldInfo> fieldInfos;
+		std::apply([&fieldInfos](const auto... members)
+			{
+				static_assert((std::is_trivially_copyable_v<std::remove_cvref_t<decltype(storage.Object.*members)>> && ...), "Declared fields must be trivially copyable.");
+				(fieldInfos.emplace_back(FieldInfo{
+					.Offset = static_cast<size_t>(reinterpret_cast<const std::byte*>(&(storage.Object.*members)) - reinterpret_cast<const std::byte*>(&storage.Object)),
+					.Size = sizeof(storage.Object.*members),
+					.Alignment = alignof(std::remove_cvref_t<decltype(storage.Object.*members)>) }), ...);
+			}, ComponentFields<T>::Members);
+
+		return fieldInfos;
 	}
 
+	/** Lifecycle of component type over consecutive objects, instantiated once per type and stored as plain function pointers. */
+	template <typename T>
+	struct ComponentLifecycle
+	{
+		static void ConstructRange(void* first, const size_t count)
+		{
+			std::uninitialized_value_construct_n(static_cast<T*>(first), count);
+		}
+
+		static void DestroyRange(void* first, const size_t count) noexcept
+		{
+			std::destroy_n(static_cast<T*>(first), count);
+		}
+
+		/** Move construct objects into destination, then destroy source objects. */
+		static void RelocateRange(void* dest, void* src, const size_t count) noexcept
+		{
+			T* destObjects = static_cast<T*>(dest);
+			T* srcObjects = static_cast<T*>(src);
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				new (destObjects + idx) T(std::move(srcObjects[idx]));
+				srcObjects[idx].~T();
+			}
+		}
+	};
+
+	using ConstructRangeFunction = void(*)(void* first, size_t count);
+	using DestroyRangeFunction = void(*)(void* first, size_t count) noexcept;
+	using RelocateRangeFunction = void(*)(void* dest, void* src, size_t count) noexcept;
+
 	struct ComponentInfo
 	{
 		ComponentID ID = INVALID_COMPONENT_ID;
 		std::string Name;
 		size_t Size = 0;
 		size_t Alignment = 1;
+		bool bIsEnableable = false;
+		bool bIsShared = false;
+		bool bIsTag = false;
+		/** Value initialization of trivially constructible component is same as filling zero. */
+		bool bIsTriviallyConstructible = true;
+		bool bIsTriviallyDestructible = true;
+		/** Trivially relocatable component is moved between rows as raw memory. */
+		bool bIsTriviallyRelocatable = true;
+		/** nullptr if component is trivially relocatable. */
+		RelocateRangeFunction RelocateRange = nullptr;
+		/** Not empty if component is stored as sub-column per field. */
+		std::vector<FieldInfo> Fields = {};
 
 		template <typename T>
 		static ComponentInfo Generate()
+		{
+			return Generate<T>(QueryComponentID<T>());
+		}
+
+		template <typename T>
+		static ComponentInfo Generate(const ComponentID componentID)
 		{
 			ComponentInfo result{
-				.ID = QueryComponentID<T>(),
+				.ID = componentID,
 				.Name = typeid(T).name(),
-				.Size = sizeof(T),
-				.Alignment = alignof(T) };
+				.Size = IS_TAG_COMPONENT<T> ? 0 : sizeof(T),
+				.Alignment = alignof(T),
+				.bIsEnableable = IS_ENABLEABLE_COMPONENT<T>,
+				.bIsShared = IS_SHARED_COMPONENT<T>,
+				.bIsTag = IS_TAG_COMPONENT<T>,
+				.bIsTriviallyConstructible = std::is_trivially_default_constructible_v<T>,
+				.bIsTriviallyDestructible = std::is_trivially_destructible_v<T>,
+				.bIsTriviallyRelocatable = std::is_trivially_copyable_v<T> };
+
+			static_assert(std::is_move_constructible_v<T>, "Component must be movable to move between archetypes.");
+			if constexpr (!std::is_trivially_copyable_v<T>)
+			{
+				result.RelocateRange = &ComponentLifecycle<T>::RelocateRange;
+			}
+
+			static_assert(!(IS_ENABLEABLE_COMPONENT<T> && IS_SHARED_COMPONENT<T>), "Shared component can not be enableable.");
+			static_assert(!(IS_TAG_COMPONENT<T> && (IS_ENABLEABLE_COMPONENT<T> || IS_SHARED_COMPONENT<T> || FieldSplitComponentType<T>)), "Tag component can not be enableable, shared or field split.");
+			if constexpr (FieldSplitComponentType<T>)
+			{
+				result.Fields = GenerateFieldInfos<T>();
+			}
 
 			return result;
 		}
 	};
 
-	// https://forum.unity.com/threads/is-it-guaranteed-that-random-access-within-a-16kb-chunk-will-not-cause-cache-miss.709940/
-	constexpr size_t DEFAULT_CHUNK_SIZE = 16384;
-	// https://stackoverflow.com/questions/34860366/why-buffers-should-be-aligned-on-64-byte-boundary-for-best-performance
-	constexpr size_t CACHE_LINE = 64;
-
-	struct ComponentRange
+	/** Type erased lifecycle of component type. */
+	struct DynamicComponentData
 	{
-		size_t Offset = 0;
-		size_t Size = 0;
-
-		static void ComponentCopy(void* destBaseAddress, void* srcBaseAddress, size_t destComponentIdx, size_t srcComponentIdx, ComponentRange destRange, ComponentRange srcRange) noexcept
+		ComponentInfo Info;
+		ComponentHash Hash = INVALID_COMPONENT_HASH;
+		ConstructRangeFunction ConstructRange = nullptr;
+		DestroyRangeFunction DestroyRange = nullptr;
+		/** Only shared component has copy constructor and equality. */
+		void(*CopyConstructor)(void* dest, const void* src) = nullptr;
+		bool(*Equal)(const void* lhs, const void* rhs) = nullptr;
+		/** Default constructed object of field split component, declared fields are scattered from it instead of constructing temporary object. */
+		const void* DefaultFieldSource = nullptr;
+
+		/** Value construct consecutive objects, trivially constructible component is filled with zero without any call. */
+		void Construct(void* first, const size_t count = 1) const
 		{
-			assert(destRange.Size == srcRange.Size);
-			void* dest = (void*)((uintptr_t)destBaseAddress + destRange.Offset + (destComponentIdx * destRange.Size));
-			const void* src = (void*)((uintptr_t)srcBaseAddress + srcRange.Offset + (srcComponentIdx * srcRange.Size));
-			std::memcpy(dest, src, srcRange.Size);
+			if (Info.bIsTriviallyConstructible)
+			{
+				std::memset(first, 0, Info.Size * count);
+			}
+			else
+			{
+				ConstructRange(first, count);
+			}
 		}
 
-		static void* ComponentAddress(void* baseAddress, size_t componentIdx, ComponentRange range) noexcept
+		/** Nothing happens if component is trivially destructible. */
+		void Destroy(void* first, const size_t count = 1) const noexcept
 		{
-			return (void*)((uintptr_t)baseAddress + range.Offset + (componentIdx * range.Size));
+			if (!Info.bIsTriviallyDestructible)
+			{
+				DestroyRange(first, count);
+			}
 		}
 	};
 
-	class Chunk
+	/**
+	* Component type is registered when it is queried at first time, so there is no static object constructed per component type at startup.
+	* ID of component type is index of its data, so per component tables are flat arrays indexed by ID.
+	*/
+	class ComponentRegistry
 	{
-		using PoolType = std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>;
+	private:
+		struct Storage
+		{
+			std::mutex Mutex;
+			std::array<DynamicComponentData, MAX_NUM_OF_COMPONENTS> Data;
+			std::atomic<size_t> NumOfComponents = 0;
+		};
+
 	public:
-		Chunk(const size_t maxNumOfAllocations) :
-			mem(_aligned_malloc(DEFAULT_CHUNK_SIZE, CACHE_LINE)),
-			allocationPool({}),
-			maxNumOfAllocations(maxNumOfAllocations)
+		/** Only called once per type, through QueryComponentID. */
+		template <ComponentType T>
+		static ComponentID Register()
 		{
-			for (size_t allocationIndex = 0; allocationIndex < MaxNumOfAllocations(); ++allocationIndex)
+			static_assert(!IS_SHARED_COMPONENT<T> || SharedComponentType<T>, "Shared component must be equality comparable and copy constructible.");
+			constexpr ComponentHash hash = QueryComponentHash<T>();
+
+			Storage& storage = ReferenceStorage();
+			std::lock_guard lock{ storage.Mutex };
+			const bool bIsHashCollided = FindComponentIDUnsafe(storage, hash) != INVALID_COMPONENT_ID;
+			assert(!bIsHashCollided && "Hash of component type collides with other component type, rename one of them.");
+
+			const ComponentID componentID = static_cast<ComponentID>(storage.NumOfComponents.load(std::memory_order_relaxed));
+			assert(componentID < MAX_NUM_OF_COMPONENTS && "Number of component types exceeds MAX_NUM_OF_COMPONENTS.");
+			DynamicComponentData& data = storage.Data.at(componentID);
+			data.Info = ComponentInfo::Generate<T>(componentID);
+			data.Hash = hash;
+			data.ConstructRange = &ComponentLifecycle<T>::ConstructRange;
+			data.DestroyRange = &ComponentLifecycle<T>::DestroyRange;
+			if constexpr (FieldSplitComponentType<T>)
 			{
-				allocationPool.push(allocationIndex);
+				static const T defaultObject = T();
+				data.DefaultFieldSource = &defaultObject;
+			}
+			if constexpr (SharedComponentType<T>)
+			{
+				data.CopyConstructor = [](void* ptr, const void* src) { new (ptr) T(*reinterpret_cast<const T*>(src)); };
+				data.Equal = [](const void* lhs, const void* rhs) { return *reinterpret_cast<const T*>(lhs) == *reinterpret_cast<const T*>(rhs); };
 			}
-		}
 
-		Chunk(Chunk&& rhs) noexcept :
-			mem(std::exchange(rhs.mem, nullptr)),
-			allocationPool(std::move(rhs.allocationPool)),
-			maxNumOfAllocations(std::exchange(rhs.maxNumOfAllocations, 0))
-		{
+			storage.NumOfComponents.store(componentID + 1, std::memory_order_release);
+			return componentID;
 		}
 
-		~Chunk()
+		[[nodiscard]] static const DynamicComponentData& DataOf(const ComponentID componentID) noexcept
 		{
-			if (mem != nullptr)
-			{
-				_aligned_free(mem);
-				mem = nullptr;
-			}
+			assert(componentID < NumOfComponents());
+			return ReferenceStorage().Data[componentID];
 		}
 
-		Chunk(const Chunk&) = delete;
-		Chunk& operator=(const Chunk&) = delete;
-		Chunk& operator=(Chunk&& rhs) noexcept
+		[[nodiscard]] static size_t NumOfComponents() noexcept
 		{
-			mem = std::exchange(rhs.mem, nullptr);
-			allocationPool = std::move(rhs.allocationPool);
-			maxNumOfAllocations = std::exchange(rhs.maxNumOfAllocations, 0);
-			return (*this);
+			return ReferenceStorage().NumOfComponents.load(std::memory_order_acquire);
 		}
 
-		/** Return index of allocation */
-		size_t Allocate()
+		/** Return INVALID_COMPONENT_ID if there is no registered component type which has given hash. */
+		[[nodiscard]] static ComponentID FindComponentID(const ComponentHash hash)
 		{
-			assert(!IsFull());
-			const size_t alloc = allocationPool.top();
-			allocationPool.pop();
-			return alloc;
+			Storage& storage = ReferenceStorage();
+			std::lock_guard lock{ storage.Mutex };
+			return FindComponentIDUnsafe(storage, hash);
 		}
 
-		/** Return moved allocation, only if return 0 when numOfAllocation is 1 */
-		void Deallocate(size_t at)
+	private:
+		/** Constructed at first use, so registration does not depend on order of static initialization. */
+		static Storage& ReferenceStorage()
 		{
-			assert(at < MaxNumOfAllocations());
-			allocationPool.push(at);
+			static Storage storage;
+			return storage;
 		}
 
-		[[nodiscard]] void* BaseAddress() const noexcept
+		[[nodiscard]] static ComponentID FindComponentIDUnsafe(const Storage& storage, const ComponentHash hash) noexcept
 		{
-			return mem;
+			const size_t numOfComponents = storage.NumOfComponents.load(std::memory_order_relaxed);
+			for (size_t componentID = 0; componentID < numOfComponents; ++componentID)
+			{
+				if (storage.Data[componentID].Hash == hash)
+				{
+					return static_cast<ComponentID>(componentID);
+				}
+			}
+
+			return INVALID_COMPONENT_ID;
 		}
 
-		[[nodiscard]] bool IsEmpty() const noexcept { return allocationPool.size() == MaxNumOfAllocations(); }
-		[[nodiscard]] bool IsFull() const noexcept { return allocationPool.empty(); }
-		[[nodiscard]] size_t MaxNumOfAllocations() const noexcept { return maxNumOfAllocations; }
-		[[nodiscard]] size_t NumOfAllocations() const noexcept { return MaxNumOfAllocations() - allocationPool.size(); }
+	};
 
-	private:
-		void* mem;
-		PoolType allocationPool;
-		size_t maxNumOfAllocations;
+	template <ComponentType T>
+	ComponentID QueryComponentID()
+	{
+		static_assert(QueryComponentHash<T>() != INVALID_COMPONENT_HASH, "Component type must be declared through DeclareComponent.");
+		static const ComponentID componentID = ComponentRegistry::Register<T>();
+		return componentID;
+	}
 
-	};
+	// https://forum.unity.com/threads/is-it-guaranteed-that-random-access-within-a-16kb-chunk-will-not-cause-cache-miss.709940/
+	constexpr size_t DEFAULT_CHUNK_SIZE = 16384;
+	/** Chunk list picks smallest size class which can hold at least MIN_NUM_OF_ALLOCATIONS_PER_CHUNK rows. */
+	constexpr std::array<size_t, 3> CHUNK_SIZE_CLASSES = { DEFAULT_CHUNK_SIZE, DEFAULT_CHUNK_SIZE * 4, DEFAULT_CHUNK_SIZE * 16 };
+	constexpr size_t MIN_NUM_OF_ALLOCATIONS_PER_CHUNK = 32;
+	/** Chunks larger than biggest size class are rounded up to page size and bypass recycling. */
+	constexpr size_t OVERSIZED_CHUNK_GRANULARITY = 4096;
+	// https://stackoverflow.com/questions/34860366/why-buffers-should-be-aligned-on-64-byte-boundary-for-best-performance
+	constexpr size_t CACHE_LINE = 64;
+	/** Slabs are 2 MB, so it can be backed by single transparent huge page. */
+	constexpr size_t DEFAULT_SLAB_SIZE = 2 * 1024 * 1024;
+	/** Maximum size of free chunk memory which chunk allocator keeps per size class after trim. */
+	constexpr size_t DEFAULT_CHUNK_RETENTION_LIMIT = 32 * 1024 * 1024;
 
-	class ChunkList
+	/**
+	* @brief	Recycles chunk memory across every chunk lists.
+	* Each chunk size class carves chunks out of large slabs. Freed chunks go to per-thread cache first and overflowed ones go to central free list,
+	* memory only returns to OS through Trim, when whole slab is free and retained memory exceeds retention limit.
+	*/
+	class ChunkAllocator
 	{
 	public:
-		struct Allocation
+		struct Statistics
 		{
-			size_t ChunkIndex = std::numeric_limits<size_t>::max();
-			size_t AllocationIndexOfEntity = std::numeric_limits<size_t>::max();
+			/** Num of allocations which served by recycled chunk. */
+			size_t Hits = 0;
+			/** Num of allocations which had to carve fresh chunk out of slab or allocate oversized chunk. */
+			size_t Misses = 0;
+			size_t NumOfSlabs = 0;
+			size_t NumOfRetainedChunks = 0;
+		};
 
-			[[nodiscard]] bool IsFailedToAllocate() const noexcept { return (ChunkIndex == static_cast<size_t>(-1)) || (AllocationIndexOfEntity == static_cast<size_t>(-1)); }
+		static constexpr size_t NUM_OF_THREAD_CACHES = 64;
+		static constexpr size_t THREAD_CACHE_CAPACITY = 32;
+
+	private:
+		struct alignas(CACHE_LINE) ThreadCache
+		{
+			std::mutex Mutex;
+			size_t NumOfChunks = 0;
+			std::array<void*, THREAD_CACHE_CAPACITY> Chunks;
 		};
 
-		struct ComponentAllocationInfo
+		/** Recycling pool of single chunk size class. */
+		struct SizeClassPool
 		{
-			ComponentRange Range;
-			ComponentID ID = INVALID_COMPONENT_ID;
+			size_t ChunkSize = 0;
+			std::array<ThreadCache, NUM_OF_THREAD_CACHES> ThreadCaches;
+			std::mutex CentralMutex;
+			std::vector<void*> CentralFreeChunks;
+			/** Slab base address -> num of chunks of slab which are in central free list. */
+			robin_hood::unordered_flat_map<uintptr_t, size_t> Slabs;
+			uintptr_t CarveCursor = 0;
+			uintptr_t CarveEnd = 0;
 		};
 
 	public:
-		ChunkList(const std::vector<ComponentInfo>& componentInfos)
+		ChunkAllocator(const size_t retentionLimit = DEFAULT_CHUNK_RETENTION_LIMIT) :
+			retentionLimit(retentionLimit)
 		{
-			size_t offset = 0;
-			if (!componentInfos.empty())
-			{
-				for (const ComponentInfo& info : componentInfos)
-				{
-					componentAllocInfos.emplace_back(ComponentAllocationInfo
-						{
-							.Range = ComponentRange
-							{
-								.Offset = offset,
-								.Size = info.Size
-							},
-							.ID = info.ID
-						});
-					offset += info.Size;
-				}
-
-				componentAllocInfos.shrink_to_fit();
-			}
-
-			sizeOfData = offset;
-			// assume component offsets are aligned as cache line. then calculate maximum align adjustment[1, CACHE_LINE-1](Not a optimal)
-			// @TODO	Optimal alignment memory reservation.
-			const size_t actualUsableChunkSize = (DEFAULT_CHUNK_SIZE - ((componentAllocInfos.size() - 1) * (CACHE_LINE - 1)));
-			maxNumOfAllocationsPerChunk = offset == 0 ? 0 : (actualUsableChunkSize / sizeOfData);
-
-			for (size_t idx = 1; idx < componentAllocInfos.size(); ++idx)
+			for (size_t sizeClass = 0; sizeClass < CHUNK_SIZE_CLASSES.size(); ++sizeClass)
 			{
-				const auto& beforeAllocInfo = componentAllocInfos.at(idx - 1);
-				auto& allocInfo = componentAllocInfos.at(idx);
-
-				allocInfo.Range.Offset = beforeAllocInfo.Range.Offset + (maxNumOfAllocationsPerChunk * beforeAllocInfo.Range.Size);
-				allocInfo.Range.Offset += utils::AlignForwardAdjustment(allocInfo.Range.Offset, CACHE_LINE);
+				static_assert(DEFAULT_SLAB_SIZE % CHUNK_SIZE_CLASSES.back() == 0);
+				pools[sizeClass].ChunkSize = CHUNK_SIZE_CLASSES[sizeClass];
 			}
 		}
 
-		ChunkList(ChunkList&& rhs) noexcept :
-			chunks(std::move(rhs.chunks)),
-			componentAllocInfos(std::move(rhs.componentAllocInfos)),
-			sizeOfData(rhs.sizeOfData),
-			maxNumOfAllocationsPerChunk(rhs.maxNumOfAllocationsPerChunk)
+		~ChunkAllocator()
 		{
+			for (SizeClassPool& pool : pools)
+			{
+				for (const auto& slab : pool.Slabs)
+				{
+					ReleasePages(reinterpret_cast<void*>(slab.first), DEFAULT_SLAB_SIZE);
+				}
+			}
 		}
 
-		~ChunkList() = default;
-
-		ChunkList(const ChunkList&) = delete;
-		ChunkList& operator=(const ChunkList&) = delete;
+		ChunkAllocator(const ChunkAllocator&) = delete;
+		ChunkAllocator(ChunkAllocator&&) = delete;
+		ChunkAllocator& operator=(const ChunkAllocator&) = delete;
+		ChunkAllocator& operator=(ChunkAllocator&&) = delete;
 
-		ChunkList& operator=(ChunkList&& rhs) noexcept
+		/** Round up requested chunk size to size class, or to oversized chunk granularity when it exceed every size classes. */
+		[[nodiscard]] static size_t ActualChunkSize(const size_t chunkSize) noexcept
 		{
-			chunks = std::move(rhs.chunks);
-			componentAllocInfos = std::move(rhs.componentAllocInfos);
-			sizeOfData = rhs.sizeOfData;
-			maxNumOfAllocationsPerChunk = rhs.maxNumOfAllocationsPerChunk;
-			return (*this);
+			for (const size_t sizeClassChunkSize : CHUNK_SIZE_CLASSES)
+			{
+				if (chunkSize <= sizeClassChunkSize)
+				{
+					return sizeClassChunkSize;
+				}
+			}
+
+			return chunkSize + utils::AlignForwardAdjustment(chunkSize, OVERSIZED_CHUNK_GRANULARITY);
 		}
 
-		/** It doesn't call anyof constructor. */
-		Allocation Create()
+		/** Returned memory is aligned as chunk size when it fits in size class, otherwise it is aligned as oversized chunk granularity. */
+		[[nodiscard]] void* Allocate(const size_t chunkSize)
 		{
-			assert(sizeOfData > 0);
-			const size_t freeChunkIndex = FreeChunkIndex();
-			if (const bool bDoesNotFoundFreeChunk = freeChunkIndex >= chunks.size(); bDoesNotFoundFreeChunk)
+			SizeClassPool* pool = PoolOf(chunkSize);
+			if (pool == nullptr)
 			{
-				chunks.emplace_back(maxNumOfAllocationsPerChunk);
+				misses.fetch_add(1, std::memory_order_relaxed);
+				return AllocatePages(ActualChunkSize(chunkSize), OVERSIZED_CHUNK_GRANULARITY);
 			}
 
-			Chunk& chunk = chunks.at(freeChunkIndex);
-			const size_t allocIndex = chunk.Allocate();
+			ThreadCache& threadCache = pool->ThreadCaches[ThreadCacheIndex()];
+			{
+				std::lock_guard lock{ threadCache.Mutex };
+				if (threadCache.NumOfChunks > 0)
+				{
+					hits.fetch_add(1, std::memory_order_relaxed);
+					return threadCache.Chunks[--threadCache.NumOfChunks];
+				}
+			}
 
-			return Allocation{
-				.ChunkIndex = freeChunkIndex,
-				.AllocationIndexOfEntity = allocIndex
-			};
+			std::lock_guard lock{ pool->CentralMutex };
+			if (!pool->CentralFreeChunks.empty())
+			{
+				hits.fetch_add(1, std::memory_order_relaxed);
+				void* chunk = pool->CentralFreeChunks.back();
+				pool->CentralFreeChunks.pop_back();
+				--pool->Slabs[SlabOf(chunk)];
+				return chunk;
+			}
+
+			misses.fetch_add(1, std::memory_order_relaxed);
+			if (pool->CarveCursor == pool->CarveEnd)
+			{
+				pool->CarveCursor = reinterpret_cast<uintptr_t>(AllocatePages(DEFAULT_SLAB_SIZE, DEFAULT_SLAB_SIZE));
+				pool->CarveEnd = pool->CarveCursor + DEFAULT_SLAB_SIZE;
+				pool->Slabs[pool->CarveCursor] = 0;
+			}
+
+			void* chunk = reinterpret_cast<void*>(pool->CarveCursor);
+			pool->CarveCursor += pool->ChunkSize;
+			return chunk;
 		}
 
-		/** It does'nt call any destructor. */
-		void Destroy(const Allocation allocation)
+		void Deallocate(void* chunk, const size_t chunkSize)
 		{
-			assert(!allocation.IsFailedToAllocate());
-			assert(allocation.ChunkIndex < chunks.size());
-			chunks.at(allocation.ChunkIndex).Deallocate(allocation.AllocationIndexOfEntity);
+			assert(chunk != nullptr);
+			SizeClassPool* pool = PoolOf(chunkSize);
+			if (pool == nullptr)
+			{
+				ReleasePages(chunk, ActualChunkSize(chunkSize));
+				return;
+			}
+
+			ThreadCache& threadCache = pool->ThreadCaches[ThreadCacheIndex()];
+			std::lock_guard lock{ threadCache.Mutex };
+			if (threadCache.NumOfChunks == THREAD_CACHE_CAPACITY)
+			{
+				/** Hand over older half of cache to central free list. */
+				constexpr size_t numOfFlushChunks = THREAD_CACHE_CAPACITY / 2;
+				std::lock_guard centralLock{ pool->CentralMutex };
+				for (size_t idx = 0; idx < numOfFlushChunks; ++idx)
+				{
+					PushToCentral(*pool, threadCache.Chunks[idx]);
+				}
+
+				std::move(threadCache.Chunks.begin() + numOfFlushChunks, threadCache.Chunks.end(), threadCache.Chunks.begin());
+				threadCache.NumOfChunks -= numOfFlushChunks;
+			}
+
+			threadCache.Chunks[threadCache.NumOfChunks++] = chunk;
 		}
 
-		ComponentAllocationInfo AllocationInfoOfComponent(const ComponentID componentID) const
+		/**
+		* Flush every thread caches to central free list, then release completely free slabs until retained memory of each size class is under retention limit.
+		* @return	Size of memory which returned to OS in bytes.
+		*/
+		size_t Trim()
 		{
-			auto found = std::find_if(componentAllocInfos.cbegin(), componentAllocInfos.cend(), [componentID](const ComponentAllocationInfo& info)
-				{
-					return componentID == info.ID;
-				});
+			size_t releasedSize = 0;
+			for (SizeClassPool& pool : pools)
+			{
+				releasedSize += Trim(pool);
+			}
 
-			return (*found);
+			return releasedSize;
 		}
 
-		[[nodiscard]] bool Support(const ComponentID componentID) const
+		[[nodiscard]] Statistics QueryStatistics()
 		{
-			const auto found = std::find_if(componentAllocInfos.cbegin(), componentAllocInfos.cend(), [componentID](const ComponentAllocationInfo& info)
+			Statistics statistics{
+				.Hits = hits.load(std::memory_order_relaxed),
+				.Misses = misses.load(std::memory_order_relaxed) };
+
+			for (SizeClassPool& pool : pools)
+			{
+				for (ThreadCache& threadCache : pool.ThreadCaches)
 				{
-					return componentID == info.ID;
-				});
+					std::lock_guard lock{ threadCache.Mutex };
+					statistics.NumOfRetainedChunks += threadCache.NumOfChunks;
+				}
+
+				std::lock_guard centralLock{ pool.CentralMutex };
+				statistics.NumOfSlabs += pool.Slabs.size();
+				statistics.NumOfRetainedChunks += pool.CentralFreeChunks.size();
+			}
 
-			return found != componentAllocInfos.cend();
+			return statistics;
 		}
 
-		[[nodiscard]] void* BaseAddressOf(const Allocation allocation) const
+		void SetRetentionLimit(const size_t newRetentionLimit) noexcept
 		{
-			void* baseAddress = chunks.at(allocation.ChunkIndex).BaseAddress();
-			return baseAddress;
+			retentionLimit.store(newRetentionLimit, std::memory_order_relaxed);
 		}
 
-		[[nodiscard]] void* AddressOf(const Allocation allocation, const ComponentID componentID) const
+	private:
+		static size_t ThreadCacheIndex() noexcept
 		{
-			const bool bIsValidChunkIndex = allocation.ChunkIndex < chunks.size();
-			assert(bIsValidChunkIndex);
+			static std::atomic<size_t> threadCounter = 0;
+			static thread_local const size_t threadCacheIndex = threadCounter.fetch_add(1, std::memory_order_relaxed) % NUM_OF_THREAD_CACHES;
+			return threadCacheIndex;
+		}
 
-			if (Support(componentID))
-			{
-				const auto componentAllocInfo = AllocationInfoOfComponent(componentID);
-				void* baseAddress = chunks.at(allocation.ChunkIndex).BaseAddress();
+		static uintptr_t SlabOf(void* chunk) noexcept
+		{
+			return reinterpret_cast<uintptr_t>(chunk) & ~(DEFAULT_SLAB_SIZE - 1);
+		}
 
-				return ComponentRange::ComponentAddress(baseAddress, allocation.AllocationIndexOfEntity, componentAllocInfo.Range);
+		[[nodiscard]] SizeClassPool* PoolOf(const size_t chunkSize) noexcept
+		{
+			for (SizeClassPool& pool : pools)
+			{
+				if (chunkSize <= pool.ChunkSize)
+				{
+					return &pool;
+				}
 			}
 
 			return nullptr;
 		}
 
-		[[nodiscard]] bool IsChunkFull(const size_t chunkIndex) const noexcept
+		/** Central mutex of pool must be locked. */
+		static void PushToCentral(SizeClassPool& pool, void* chunk)
 		{
-			assert(chunkIndex < chunks.size());
-			return chunks.at(chunkIndex).IsFull();
+			pool.CentralFreeChunks.emplace_back(chunk);
+			++pool.Slabs[SlabOf(chunk)];
 		}
 
-		[[nodiscard]] size_t FreeChunkIndex() const noexcept
+		size_t Trim(SizeClassPool& pool)
 		{
-			size_t freeChunkIndex = 0;
-			for (; freeChunkIndex < chunks.size(); ++freeChunkIndex)
+			/** Deallocate locks thread cache before central mutex, so drain thread caches before taking central mutex to keep same lock order. */
+			std::vector<void*> drainedChunks;
+			for (ThreadCache& threadCache : pool.ThreadCaches)
+			{
+				std::lock_guard lock{ threadCache.Mutex };
+				drainedChunks.insert(drainedChunks.end(), threadCache.Chunks.begin(), threadCache.Chunks.begin() + threadCache.NumOfChunks);
+				threadCache.NumOfChunks = 0;
+			}
+
+			std::lock_guard centralLock{ pool.CentralMutex };
+			for (void* chunk : drainedChunks)
+			{
+				PushToCentral(pool, chunk);
+			}
+
+			const size_t numOfChunksPerSlab = DEFAULT_SLAB_SIZE / pool.ChunkSize;
+			const size_t limit = retentionLimit.load(std::memory_order_relaxed);
+			const uintptr_t carvingSlab = pool.CarveCursor == pool.CarveEnd ? 0 : SlabOf(reinterpret_cast<void*>(pool.CarveCursor));
+			size_t retainedSize = pool.CentralFreeChunks.size() * pool.ChunkSize;
+			std::vector<uintptr_t> releaseSlabs;
+			for (const auto& [slab, numOfFreeChunks] : pool.Slabs)
 			{
-				if (!chunks.at(freeChunkIndex).IsFull())
+				if (retainedSize <= limit)
 				{
 					break;
 				}
+
+				if (numOfFreeChunks == numOfChunksPerSlab && slab != carvingSlab)
+				{
+					releaseSlabs.emplace_back(slab);
+					retainedSize -= DEFAULT_SLAB_SIZE;
+				}
 			}
 
-			return freeChunkIndex;
-		}
+			if (!releaseSlabs.empty())
+			{
+				std::erase_if(pool.CentralFreeChunks, [&releaseSlabs](void* chunk)
+					{
+						return std::find(releaseSlabs.cbegin(), releaseSlabs.cend(), SlabOf(chunk)) != releaseSlabs.cend();
+					});
 
-		size_t ShrinkToFit()
-		{
-			// Erase-Remove idiom
-			const auto reduced = std::erase_if(chunks, [](Chunk& chunk) noexcept {
-				return chunk.IsEmpty();
-				});
+				for (const uintptr_t slab : releaseSlabs)
+				{
+					pool.Slabs.erase(slab);
+					ReleasePages(reinterpret_cast<void*>(slab), DEFAULT_SLAB_SIZE);
+				}
+			}
 
-			chunks.shrink_to_fit();
-			return reduced;
+			return releaseSlabs.size() * DEFAULT_SLAB_SIZE;
 		}
 
-		/** Just memory data copy, it never call any constructor or destructor. */
-		static void MoveData(ChunkList& srcChunkList, const Allocation srcAllocation, const ChunkList& destChunkList, const Allocation destAllocation)
+		/** Slabs are aligned as its size, so owner slab of chunk can be found by masking address. */
+		static void* AllocatePages(const size_t size, const size_t alignment)
 		{
-			bool bIsValid = !srcAllocation.IsFailedToAllocate() && !destAllocation.IsFailedToAllocate();
-			assert(bIsValid);
+#if defined(__linux__)
+			/** Over-reserve to align memory, then give back unaligned head and tail. */
+			const size_t reservedSize = size + alignment;
+			void* reserved = mmap(nullptr, reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (reserved == MAP_FAILED)
+			{
+				throw std::bad_alloc();
+			}
 
-			bIsValid = bIsValid && (srcAllocation.ChunkIndex < srcChunkList.chunks.size() && destAllocation.ChunkIndex < destChunkList.chunks.size());
-			assert(bIsValid);
+			const uintptr_t reservedBegin = reinterpret_cast<uintptr_t>(reserved);
+			const uintptr_t begin = reservedBegin + utils::AlignForwardAdjustment(reservedBegin, alignment);
+			const size_t headSize = begin - reservedBegin;
+			const size_t tailSize = reservedSize - headSize - size;
+			if (headSize > 0)
+			{
+				munmap(reserved, headSize);
+			}
 
-			if (bIsValid)
+			if (tailSize > 0)
 			{
-				void* srcAddress = srcChunkList.BaseAddressOf(srcAllocation);
-				void* destAddress = destChunkList.BaseAddressOf(destAllocation);
-				const auto& srcComponentAllocInfos = srcChunkList.componentAllocInfos;
-				const auto& destComponentAllocInfos = destChunkList.componentAllocInfos;
-				for (const auto& srcComponentAllocInfo : srcComponentAllocInfos)
-				{
-					for (const auto& destComponentAllocInfo : destComponentAllocInfos)
-					{
-						if (srcComponentAllocInfo.ID == destComponentAllocInfo.ID)
-						{
-							ComponentRange::ComponentCopy(destAddress, srcAddress, destAllocation.AllocationIndexOfEntity, srcAllocation.AllocationIndexOfEntity, destComponentAllocInfo.Range, srcComponentAllocInfo.Range);
-						}
-					}
-				}
+				munmap(reinterpret_cast<void*>(begin + size), tailSize);
+			}
 
-				srcChunkList.Destroy(srcAllocation);
+			if (size >= DEFAULT_SLAB_SIZE)
+			{
+				/** Hint to back with transparent huge page to cut TLB misses during iteration. */
+				madvise(reinterpret_cast<void*>(begin), size, MADV_HUGEPAGE);
+			}
+
+			return reinterpret_cast<void*>(begin);
+#else
+			void* mem = _aligned_malloc(size, alignment);
+			if (mem == nullptr)
+			{
+				throw std::bad_alloc();
 			}
+
+			return mem;
+#endif
+		}
+
+		static void ReleasePages(void* mem, [[maybe_unused]] const size_t size)
+		{
+#if defined(__linux__)
+			munmap(mem, size);
+#else
+			_aligned_free(mem);
+#endif
 		}
 
 	private:
-		std::vector<Chunk> chunks;
-		std::vector<ComponentAllocationInfo> componentAllocInfos;
-		size_t sizeOfData;
-		size_t maxNumOfAllocationsPerChunk;
+		std::array<SizeClassPool, CHUNK_SIZE_CLASSES.size()> pools;
+		std::atomic<size_t> retentionLimit;
+		std::atomic<size_t> hits = 0;
+		std::atomic<size_t> misses = 0;
 
 	};
 
-	using Archetype = std::set<ComponentID>;
+	struct ComponentRange
+	{
+		size_t Offset = 0;
+		size_t Size = 0;
 
-	/**
-	* @brief	ComponentArchive itself guarantee thread-safety when SY_ECS_THREAD_SAFE is true. But write to component data which stored inside of chunk is not a thread-safe.
-	*/
-	class ComponentArchive
+		/** Source objects are left destroyed, component which is trivially relocatable(relocateRange is nullptr) is copied as raw memory. */
+		static void ComponentRelocate(void* destBaseAddress, void* srcBaseAddress, size_t destComponentIdx, size_t srcComponentIdx, ComponentRange destRange, ComponentRange srcRange, const RelocateRangeFunction relocateRange, const size_t count = 1) noexcept
+		{
+			assert(destRange.Size == srcRange.Size);
+			void* dest = (void*)((uintptr_t)destBaseAddress + destRange.Offset + (destComponentIdx * destRange.Size));
+			void* src = (void*)((uintptr_t)srcBaseAddress + srcRange.Offset + (srcComponentIdx * srcRange.Size));
+			if (relocateRange != nullptr)
+			{
+				relocateRange(dest, src, count);
+			}
+			else
+			{
+				std::memcpy(dest, src, srcRange.Size * count);
+			}
+		}
+
+		static void* ComponentAddress(void* baseAddress, size_t componentIdx, ComponentRange range) noexcept
+		{
+			return (void*)((uintptr_t)baseAddress + range.Offset + (componentIdx * range.Size));
+		}
+	};
+
+	class Chunk
 	{
 	public:
-		struct DynamicComponentData
+		/** Occupancy is tracked by two-level bitmask(one summary word over 64 slot words), so chunk can hold at most 64 * 64 allocations. */
+		static constexpr size_t MAX_NUM_OF_ALLOCATIONS = 64 * 64;
+
+	private:
+		using SlotMask = uint64_t;
+		static constexpr size_t BITS_PER_SLOT_MASK = std::numeric_limits<SlotMask>::digits;
+		static constexpr size_t NUM_OF_SLOT_MASKS = MAX_NUM_OF_ALLOCATIONS / BITS_PER_SLOT_MASK;
+		static_assert(NUM_OF_SLOT_MASKS <= BITS_PER_SLOT_MASK, "Summary mask must be able to cover every slot masks.");
+
+	public:
+		Chunk(ChunkAllocator& allocator, const size_t chunkSize, const size_t maxNumOfAllocations) :
+			allocator(&allocator),
+			mem(allocator.Allocate(chunkSize)),
+			freeSlotMasks({}),
+			freeSlotMaskSummary(0),
+			chunkSize(chunkSize),
+			maxNumOfAllocations(maxNumOfAllocations),
+			numOfAllocations(0)
 		{
-			ComponentInfo Info;
-			std::function<void(void*)> DefaultConstructor;
-			std::function<void(void*)> Destructor;
-		};
+			assert(maxNumOfAllocations <= MAX_NUM_OF_ALLOCATIONS);
+			for (size_t allocationIndex = 0; allocationIndex < MaxNumOfAllocations(); allocationIndex += BITS_PER_SLOT_MASK)
+			{
+				const size_t numOfSlots = std::min(BITS_PER_SLOT_MASK, MaxNumOfAllocations() - allocationIndex);
+				const size_t maskIndex = allocationIndex / BITS_PER_SLOT_MASK;
+				freeSlotMasks[maskIndex] = numOfSlots == BITS_PER_SLOT_MASK ? ~SlotMask(0) : ((SlotMask(1) << numOfSlots) - 1);
+				freeSlotMaskSummary |= (SlotMask(1) << maskIndex);
+			}
+		}
 
-		struct ArchetypeData
+		Chunk(Chunk&& rhs) noexcept :
+			allocator(rhs.allocator),
+			mem(std::exchange(rhs.mem, nullptr)),
+			freeSlotMasks(rhs.freeSlotMasks),
+			freeSlotMaskSummary(std::exchange(rhs.freeSlotMaskSummary, 0)),
+			chunkSize(rhs.chunkSize),
+			maxNumOfAllocations(std::exchange(rhs.maxNumOfAllocations, 0)),
+			numOfAllocations(std::exchange(rhs.numOfAllocations, 0))
 		{
-			size_t ArchetypeIndex = 0;
-			ChunkList::Allocation Allocation;
-		};
+		}
 
-		template <ComponentType T>
-		class ComponentHandle
+		~Chunk()
 		{
-		public:
-			ComponentHandle(const ComponentArchive& archive, const Entity entity) noexcept :
-				archive(archive),
-				entity(entity)
+			if (mem != nullptr)
 			{
+				allocator->Deallocate(mem, chunkSize);
+				mem = nullptr;
 			}
+		}
 
-			~ComponentHandle() = default;
+		Chunk(const Chunk&) = delete;
+		Chunk& operator=(const Chunk&) = delete;
+		Chunk& operator=(Chunk&& rhs) noexcept
+		{
+			if (mem != nullptr)
+			{
+				allocator->Deallocate(mem, chunkSize);
+			}
 
-			ComponentHandle(const ComponentHandle&) noexcept = default;
-			ComponentHandle(ComponentHandle&&) noexcept = default;
-			ComponentHandle& operator=(const ComponentHandle&) noexcept = default;
-			ComponentHandle& operator=(ComponentHandle&&) noexcept = default;
+			allocator = rhs.allocator;
+			mem = std::exchange(rhs.mem, nullptr);
+			freeSlotMasks = rhs.freeSlotMasks;
+			freeSlotMaskSummary = std::exchange(rhs.freeSlotMaskSummary, 0);
+			chunkSize = rhs.chunkSize;
+			maxNumOfAllocations = std::exchange(rhs.maxNumOfAllocations, 0);
+			numOfAllocations = std::exchange(rhs.numOfAllocations, 0);
+			return (*this);
+		}
 
-			T& operator*() { return Reference(); }
-			const T& operator*() const { return Reference(); }
+		/** Return index of allocation. Always hand out lowest free slot, so chunk fills front to back. */
+		size_t Allocate() noexcept
+		{
+			assert(!IsFull());
+			const size_t maskIndex = std::countr_zero(freeSlotMaskSummary);
+			SlotMask& freeSlotMask = freeSlotMasks[maskIndex];
+			const size_t alloc = (maskIndex * BITS_PER_SLOT_MASK) + std::countr_zero(freeSlotMask);
 
-			T* operator->() { return archive.Get<T>(entity); }
-			const T* operator->() const { return archive.Get<T>(entity); }
+			freeSlotMask &= (freeSlotMask - 1);
+			if (freeSlotMask == 0)
+			{
+				freeSlotMaskSummary &= ~(SlotMask(1) << maskIndex);
+			}
 
-			T& Reference() { return *archive.Get<T>(entity); }
-			const T& Reference() const { return *archive.Get<T>(entity); }
+			++numOfAllocations;
+			return alloc;
+		}
 
-			[[nodiscard]] Entity Owner() const noexcept { return entity; }
-			[[nodiscard]] bool IsValid() const noexcept { return archive.Contains<T>(entity); }
-			[[nodiscard]] constexpr ComponentID ID() const noexcept { return QueryComponentID<T>(); }
+		/** Allocate first given number of slots of empty chunk at once. */
+		void AllocateFront(const size_t numOfSlots) noexcept
+		{
+			assert(IsEmpty() && numOfSlots <= MaxNumOfAllocations());
+			for (size_t maskIndex = 0; maskIndex * BITS_PER_SLOT_MASK < numOfSlots; ++maskIndex)
+			{
+				const size_t numOfSlotsInMask = std::min(BITS_PER_SLOT_MASK, numOfSlots - (maskIndex * BITS_PER_SLOT_MASK));
+				freeSlotMasks[maskIndex] &= numOfSlotsInMask == BITS_PER_SLOT_MASK ? SlotMask(0) : ~((SlotMask(1) << numOfSlotsInMask) - 1);
+				if (freeSlotMasks[maskIndex] == 0)
+				{
+					freeSlotMaskSummary &= ~(SlotMask(1) << maskIndex);
+				}
+			}
 
-		private:
-			const ComponentArchive& archive;
-			const Entity entity;
+			numOfAllocations = numOfSlots;
+		}
 
-		};
+		void Deallocate(const size_t at) noexcept
+		{
+			assert(at < MaxNumOfAllocations());
+			assert(!IsFree(at) && "Double deallocation of chunk slot.");
+			const size_t maskIndex = at / BITS_PER_SLOT_MASK;
+			freeSlotMasks[maskIndex] |= (SlotMask(1) << (at % BITS_PER_SLOT_MASK));
+			freeSlotMaskSummary |= (SlotMask(1) << maskIndex);
+			--numOfAllocations;
+		}
 
-#if SY_ECS_THREAD_SAFE
-		using Mutex_t = std::shared_timed_mutex;
-		using WriteLock_t = std::unique_lock<Mutex_t>;
-		using ReadOnlyLock_t = std::shared_lock<Mutex_t>;
-#endif
+		[[nodiscard]] void* BaseAddress() const noexcept
+		{
+			return mem;
+		}
+
+		[[nodiscard]] bool IsFree(const size_t at) const noexcept
+		{
+			assert(at < MaxNumOfAllocations());
+			return (freeSlotMasks[at / BITS_PER_SLOT_MASK] & (SlotMask(1) << (at % BITS_PER_SLOT_MASK))) != 0;
+		}
+
+		/** Return one past index of highest allocated slot. */
+		[[nodiscard]] size_t Extent() const noexcept
+		{
+			for (size_t maskIndex = (MaxNumOfAllocations() + BITS_PER_SLOT_MASK - 1) / BITS_PER_SLOT_MASK; maskIndex > 0; --maskIndex)
+			{
+				const size_t numOfSlots = std::min(BITS_PER_SLOT_MASK, MaxNumOfAllocations() - ((maskIndex - 1) * BITS_PER_SLOT_MASK));
+				const SlotMask validSlotMask = numOfSlots == BITS_PER_SLOT_MASK ? ~SlotMask(0) : ((SlotMask(1) << numOfSlots) - 1);
+				const SlotMask allocatedSlotMask = ~freeSlotMasks[maskIndex - 1] & validSlotMask;
+				if (allocatedSlotMask != 0)
+				{
+					return (maskIndex * BITS_PER_SLOT_MASK) - std::countl_zero(allocatedSlotMask);
+				}
+			}
+
+			return 0;
+		}
+
+		[[nodiscard]] bool IsEmpty() const noexcept { return numOfAllocations == 0; }
+		[[nodiscard]] bool IsFull() const noexcept { return freeSlotMaskSummary == 0; }
+		[[nodiscard]] size_t ChunkSize() const noexcept { return chunkSize; }
+		[[nodiscard]] size_t MaxNumOfAllocations() const noexcept { return maxNumOfAllocations; }
+		[[nodiscard]] size_t NumOfAllocations() const noexcept { return numOfAllocations; }
+
+	private:
+		ChunkAllocator* allocator;
+		void* mem;
+		/** Bit is set when slot is free. */
+		std::array<SlotMask, NUM_OF_SLOT_MASKS> freeSlotMasks;
+		/** Bit is set when corresponding slot mask has at least one free slot. */
+		SlotMask freeSlotMaskSummary;
+		size_t chunkSize;
+		size_t maxNumOfAllocations;
+		size_t numOfAllocations;
+
+	};
+
+	enum class ChunkStorageMode : uint8_t
+	{
+		/** Destroyed allocation leaves hole which later allocation fills. Allocations never move by others. */
+		Sparse,
+		/** Last row of chunk moves into destroyed allocation, so allocations of each chunk are always [0, NumOfAllocations). */
+		Dense
+	};
+
+	class ChunkList
+	{
+	private:
+		static constexpr size_t BITS_PER_ENABLED_MASK = std::numeric_limits<uint64_t>::digits;
 
 	public:
-		ComponentArchive(const ComponentArchive&) = delete;
-		ComponentArchive(ComponentArchive&&) = delete;
-		ComponentArchive& operator=(const ComponentArchive&) = delete;
-		ComponentArchive& operator=(ComponentArchive&&) = delete;
+		/** Field index of column which stores whole component objects. */
+		static constexpr size_t WHOLE_COMPONENT = std::numeric_limits<size_t>::max();
 
-		~ComponentArchive() noexcept(false)
+		struct Allocation
+		{
+			size_t ChunkIndex = std::numeric_limits<size_t>::max();
+			size_t AllocationIndexOfEntity = std::numeric_limits<size_t>::max();
+
+			[[nodiscard]] bool IsFailedToAllocate() const noexcept { return (ChunkIndex == static_cast<size_t>(-1)) || (AllocationIndexOfEntity == static_cast<size_t>(-1)); }
+		};
+
+		/** New allocation of entity which moved inside of chunk list. */
+		struct Relocation
+		{
+			Entity Owner = INVALID_ENTITY_HANDLE;
+			Allocation NewAllocation;
+		};
+
+		struct ComponentAllocationInfo
+		{
+			ComponentRange Range;
+			ComponentID ID = INVALID_COMPONENT_ID;
+			/** Alignment of column begin, it can be bigger than alignment of component when column padded to cache line. */
+			size_t Alignment = 1;
+			/** Sub-column of field split component stores single field, WHOLE_COMPONENT otherwise. */
+			size_t FieldIndex = WHOLE_COMPONENT;
+			/** Offset of field inside of component object. */
+			size_t FieldOffset = 0;
+			/** nullptr if rows of column can be moved as raw memory. */
+			RelocateRangeFunction RelocateRange = nullptr;
+		};
+
+		/** Columns and enabled masks which source and destination chunk list have in common, precomputed to move rows without matching component IDs. */
+		struct TransferPlan
+		{
+			struct ColumnTransfer
+			{
+				size_t SrcOffset = 0;
+				size_t DestOffset = 0;
+				size_t Size = 0;
+				RelocateRangeFunction RelocateRange = nullptr;
+			};
+
+			std::vector<ColumnTransfer> Columns;
+			/** Pairs of enableable index in source and destination chunk list. */
+			std::vector<std::pair<size_t, size_t>> EnabledMasks;
+		};
+
+		struct Layout
+		{
+			/** Ordered as columns placed in chunk. */
+			std::vector<ComponentAllocationInfo> ComponentAllocInfos;
+			size_t MaxNumOfAllocations = 0;
+		};
+
+	public:
+		/**
+		* @param	forcedChunkSize		Use given chunk size instead of picking chunk size class from size of row. 0 means automatic.
+		* @param	sharedValues		Value of each shared components in componentInfos, in same order. Shared component does not get column.
+		* Tag component does not get column either, so chunk list of archetype which only has tag components never allocates chunk.
+		*/
+		ChunkList(ChunkAllocator& chunkAllocator, const std::vector<ComponentInfo>& componentInfos, const ChunkStorageMode storageMode = ChunkStorageMode::Sparse, const size_t forcedChunkSize = 0, const std::vector<const void*>& sharedValues = {}) :
+			chunkAllocator(&chunkAllocator),
+			sizeOfData(0),
+			storageMode(storageMode),
+			sharedValues(sharedValues)
+		{
+			/** Every chunk stores owner entity of each rows, next to component columns. */
+			std::vector<ComponentInfo> columnInfos;
+			columnInfos.reserve(componentInfos.size() + 1);
+			for (const ComponentInfo& info : componentInfos)
+			{
+				if (info.bIsShared)
+				{
+					sharedComponentIDs.emplace_back(info.ID);
+				}
+				else if (!info.bIsTag)
+				{
+					columnInfos.emplace_back(info);
+					sizeOfData += info.Size;
+				}
+			}
+
+			assert(sharedComponentIDs.size() == sharedValues.size());
+			if (!columnInfos.empty() || !sharedComponentIDs.empty())
+			{
+				columnInfos.emplace_back(ComponentInfo{
+					.ID = INVALID_COMPONENT_ID,
+					.Name = "Entity",
+					.Size = sizeof(Entity),
+					.Alignment = alignof(Entity),
+					.Fields = {} });
+			}
+
+			chunkSize = forcedChunkSize != 0 ? forcedChunkSize : SelectChunkSize(columnInfos);
+			Layout layout = ComputeLayout(columnInfos, chunkSize);
+			maxNumOfAllocationsPerChunk = layout.MaxNumOfAllocations;
+			for (const ComponentAllocationInfo& allocInfo : layout.ComponentAllocInfos)
+			{
+				if (allocInfo.ID == INVALID_COMPONENT_ID)
+				{
+					entityRange = allocInfo.Range;
+				}
+				else
+				{
+					componentAllocInfos.emplace_back(allocInfo);
+				}
+			}
+
+			/** Sub-columns of field split component are kept contiguous in field order, so field is looked up as first sub-column + field index. */
+			std::stable_sort(componentAllocInfos.begin(), componentAllocInfos.end(), [](const ComponentAllocationInfo& lhs, const ComponentAllocationInfo& rhs)
+				{
+					return lhs.ID < rhs.ID || (lhs.ID == rhs.ID && lhs.FieldIndex < rhs.FieldIndex);
+				});
+
+			for (size_t columnIndex = componentAllocInfos.size(); columnIndex > 0; --columnIndex)
+			{
+				const ComponentID componentID = componentAllocInfos[columnIndex - 1].ID;
+				if (componentID >= columnIndexLUT.size())
+				{
+					columnIndexLUT.resize(componentID + 1, componentAllocInfos.size());
+				}
+
+				columnIndexLUT[componentID] = columnIndex - 1;
+			}
+
+			for (const ComponentInfo& info : componentInfos)
+			{
+				if (info.bIsEnableable)
+				{
+					enableableComponentIDs.emplace_back(info.ID);
+				}
+			}
+
+			numOfEnabledMasksPerChunk = (maxNumOfAllocationsPerChunk + BITS_PER_ENABLED_MASK - 1) / BITS_PER_ENABLED_MASK;
+			selfTransferPlan = BuildTransferPlan(*this, *this);
+		}
+
+		ChunkList(ChunkList&& rhs) noexcept :
+			chunkAllocator(rhs.chunkAllocator),
+			chunks(std::move(rhs.chunks)),
+			nonFullChunks(std::move(rhs.nonFullChunks)),
+			componentAllocInfos(std::move(rhs.componentAllocInfos)),
+			columnIndexLUT(std::move(rhs.columnIndexLUT)),
+			entityRange(rhs.entityRange),
+			sizeOfData(rhs.sizeOfData),
+			chunkSize(rhs.chunkSize),
+			maxNumOfAllocationsPerChunk(rhs.maxNumOfAllocationsPerChunk),
+			numOfAllocations(rhs.numOfAllocations),
+			storageMode(rhs.storageMode),
+			sharedComponentIDs(std::move(rhs.sharedComponentIDs)),
+			sharedValues(std::move(rhs.sharedValues)),
+			changeVersions(std::move(rhs.changeVersions)),
+			enableableComponentIDs(std::move(rhs.enableableComponentIDs)),
+			numOfEnabledMasksPerChunk(rhs.numOfEnabledMasksPerChunk),
+			enabledMasks(std::move(rhs.enabledMasks)),
+			selfTransferPlan(std::move(rhs.selfTransferPlan)),
+			entitiesWithoutStorage(std::move(rhs.entitiesWithoutStorage))
+		{
+		}
+
+		~ChunkList() = default;
+
+		ChunkList(const ChunkList&) = delete;
+		ChunkList& operator=(const ChunkList&) = delete;
+
+		ChunkList& operator=(ChunkList&& rhs) noexcept
+		{
+			chunkAllocator = rhs.chunkAllocator;
+			chunks = std::move(rhs.chunks);
+			nonFullChunks = std::move(rhs.nonFullChunks);
+			componentAllocInfos = std::move(rhs.componentAllocInfos);
+			columnIndexLUT = std::move(rhs.columnIndexLUT);
+			entityRange = rhs.entityRange;
+			sizeOfData = rhs.sizeOfData;
+			chunkSize = rhs.chunkSize;
+			maxNumOfAllocationsPerChunk = rhs.maxNumOfAllocationsPerChunk;
+			numOfAllocations = rhs.numOfAllocations;
+			storageMode = rhs.storageMode;
+			sharedComponentIDs = std::move(rhs.sharedComponentIDs);
+			sharedValues = std::move(rhs.sharedValues);
+			changeVersions = std::move(rhs.changeVersions);
+			enableableComponentIDs = std::move(rhs.enableableComponentIDs);
+			numOfEnabledMasksPerChunk = rhs.numOfEnabledMasksPerChunk;
+			enabledMasks = std::move(rhs.enabledMasks);
+			selfTransferPlan = std::move(rhs.selfTransferPlan);
+			entitiesWithoutStorage = std::move(rhs.entitiesWithoutStorage);
+			return (*this);
+		}
+
+		/** It doesn't call anyof constructor. */
+		Allocation Create(const Entity entity)
+		{
+			assert(maxNumOfAllocationsPerChunk > 0);
+			const size_t freeChunkIndex = FreeChunkIndex();
+			if (const bool bDoesNotFoundFreeChunk = freeChunkIndex >= chunks.size(); bDoesNotFoundFreeChunk)
+			{
+				chunks.emplace_back(*chunkAllocator, chunkSize, maxNumOfAllocationsPerChunk);
+				changeVersions.resize(chunks.size() * componentAllocInfos.size(), 0);
+				enabledMasks.resize(chunks.size() * enableableComponentIDs.size() * numOfEnabledMasksPerChunk, 0);
+				nonFullChunks.Resize(chunks.size());
+				nonFullChunks.Set(freeChunkIndex);
+			}
+
+			Chunk& chunk = chunks.at(freeChunkIndex);
+			const size_t allocIndex = chunk.Allocate();
+			++numOfAllocations;
+			if (chunk.IsFull())
+			{
+				nonFullChunks.Reset(freeChunkIndex);
+			}
+
+			EntitiesOf(chunk)[allocIndex] = entity;
+			/** Enableable components are enabled by default. */
+			for (size_t enableableIndex = 0; enableableIndex < enableableComponentIDs.size(); ++enableableIndex)
+			{
+				EnabledMasksOf(freeChunkIndex, enableableIndex)[allocIndex / BITS_PER_ENABLED_MASK] |= (uint64_t(1) << (allocIndex % BITS_PER_ENABLED_MASK));
+			}
+
+			return Allocation{
+				.ChunkIndex = freeChunkIndex,
+				.AllocationIndexOfEntity = allocIndex
+			};
+		}
+
+		/**
+		* Create rows of every given entities, free slots of existing chunks are filled first then rest of rows fill new chunks front to back at once.
+		* It doesn't call any constructor.
+		* @param	function	Called with first allocation and number of rows of each contiguous run of created rows, runs are in order of entities.
+		*/
+		template <typename Function>
+		void CreateBulk(const std::span<const Entity> entities, Function&& function)
+		{
+			assert(maxNumOfAllocationsPerChunk > 0);
+			size_t entityIndex = 0;
+			for (size_t freeChunkIndex = FreeChunkIndex(); entityIndex < entities.size() && freeChunkIndex < chunks.size(); freeChunkIndex = FreeChunkIndex())
+			{
+				const size_t firstEntityIndex = entityIndex;
+				Chunk& chunk = chunks[freeChunkIndex];
+				Entity* chunkEntities = EntitiesOf(chunk);
+				Allocation runBegin{ .ChunkIndex = freeChunkIndex, .AllocationIndexOfEntity = chunk.Allocate() };
+				size_t runLength = 1;
+				chunkEntities[runBegin.AllocationIndexOfEntity] = entities[entityIndex++];
+				while (entityIndex < entities.size() && !chunk.IsFull())
+				{
+					const size_t allocIndex = chunk.Allocate();
+					chunkEntities[allocIndex] = entities[entityIndex++];
+					if (allocIndex != runBegin.AllocationIndexOfEntity + runLength)
+					{
+						EnableRows(runBegin, runLength);
+						function(runBegin, runLength);
+						runBegin.AllocationIndexOfEntity = allocIndex;
+						runLength = 0;
+					}
+
+					++runLength;
+				}
+
+				numOfAllocations += entityIndex - firstEntityIndex;
+				EnableRows(runBegin, runLength);
+				function(runBegin, runLength);
+				if (chunk.IsFull())
+				{
+					nonFullChunks.Reset(freeChunkIndex);
+				}
+			}
+
+			const size_t numOfRemainEntities = entities.size() - entityIndex;
+			const size_t firstNewChunkIndex = chunks.size();
+			const size_t numOfNewChunks = (numOfRemainEntities + maxNumOfAllocationsPerChunk - 1) / maxNumOfAllocationsPerChunk;
+			chunks.reserve(firstNewChunkIndex + numOfNewChunks);
+			for (size_t count = 0; count < numOfNewChunks; ++count)
+			{
+				chunks.emplace_back(*chunkAllocator, chunkSize, maxNumOfAllocationsPerChunk);
+			}
+
+			changeVersions.resize(chunks.size() * componentAllocInfos.size(), 0);
+			enabledMasks.resize(chunks.size() * enableableComponentIDs.size() * numOfEnabledMasksPerChunk, 0);
+			nonFullChunks.Resize(chunks.size());
+			for (size_t chunkIndex = firstNewChunkIndex; chunkIndex < chunks.size(); ++chunkIndex)
+			{
+				const size_t numOfRows = std::min(maxNumOfAllocationsPerChunk, entities.size() - entityIndex);
+				Chunk& chunk = chunks[chunkIndex];
+				chunk.AllocateFront(numOfRows);
+				std::copy_n(entities.begin() + entityIndex, numOfRows, EntitiesOf(chunk));
+				entityIndex += numOfRows;
+				if (!chunk.IsFull())
+				{
+					nonFullChunks.Set(chunkIndex);
+				}
+
+				const Allocation runBegin{ .ChunkIndex = chunkIndex, .AllocationIndexOfEntity = 0 };
+				EnableRows(runBegin, numOfRows);
+				function(runBegin, numOfRows);
+			}
+
+			numOfAllocations += numOfRemainEntities;
+		}
+
+		/**
+		* It does'nt call any destructor.
+		* @return	Entity which moved into destroyed allocation to keep chunk dense, INVALID_ENTITY_HANDLE if nothing moved.
+		*/
+		Entity Destroy(const Allocation allocation)
+		{
+			assert(!allocation.IsFailedToAllocate());
+			assert(allocation.ChunkIndex < chunks.size());
+			Chunk& chunk = chunks.at(allocation.ChunkIndex);
+			Entity* entities = EntitiesOf(chunk);
+			Entity movedEntity = INVALID_ENTITY_HANDLE;
+			size_t freeAllocationIndex = allocation.AllocationIndexOfEntity;
+			if (storageMode == ChunkStorageMode::Dense)
+			{
+				const size_t lastAllocationIndex = chunk.NumOfAllocations() - 1;
+				if (freeAllocationIndex != lastAllocationIndex)
+				{
+					void* baseAddress = chunk.BaseAddress();
+					for (const ComponentAllocationInfo& allocInfo : componentAllocInfos)
+					{
+						ComponentRange::ComponentRelocate(baseAddress, baseAddress, freeAllocationIndex, lastAllocationIndex, allocInfo.Range, allocInfo.Range, allocInfo.RelocateRange);
+					}
+
+					for (size_t enableableIndex = 0; enableableIndex < enableableComponentIDs.size(); ++enableableIndex)
+					{
+						CopyEnabledBit(EnabledMasksOf(allocation.ChunkIndex, enableableIndex), freeAllocationIndex, EnabledMasksOf(allocation.ChunkIndex, enableableIndex), lastAllocationIndex);
+					}
+
+					movedEntity = entities[lastAllocationIndex];
+					entities[freeAllocationIndex] = movedEntity;
+					freeAllocationIndex = lastAllocationIndex;
+				}
+			}
+
+			for (size_t enableableIndex = 0; enableableIndex < enableableComponentIDs.size(); ++enableableIndex)
+			{
+				EnabledMasksOf(allocation.ChunkIndex, enableableIndex)[freeAllocationIndex / BITS_PER_ENABLED_MASK] &= ~(uint64_t(1) << (freeAllocationIndex % BITS_PER_ENABLED_MASK));
+			}
+
+			entities[freeAllocationIndex] = INVALID_ENTITY_HANDLE;
+			chunk.Deallocate(freeAllocationIndex);
+			--numOfAllocations;
+			nonFullChunks.Set(allocation.ChunkIndex);
+			return movedEntity;
+		}
+
+		ComponentAllocationInfo AllocationInfoOfComponent(const ComponentID componentID) const
+		{
+			const size_t columnIndex = ColumnIndexOf(componentID);
+			assert(columnIndex != componentAllocInfos.size());
+			return componentAllocInfos[columnIndex];
+		}
+
+		[[nodiscard]] bool Support(const ComponentID componentID) const
+		{
+			return ColumnIndexOf(componentID) != componentAllocInfos.size();
+		}
+
+		[[nodiscard]] void* BaseAddressOf(const Allocation allocation) const
+		{
+			void* baseAddress = chunks.at(allocation.ChunkIndex).BaseAddress();
+			return baseAddress;
+		}
+
+		/** Return nullptr if component is not supported or field split, because field split component object does not live in chunk. */
+		[[nodiscard]] void* AddressOf(const Allocation allocation, const ComponentID componentID) const
+		{
+			const bool bIsValidChunkIndex = allocation.ChunkIndex < chunks.size();
+			assert(bIsValidChunkIndex);
+
+			const size_t columnIndex = ColumnIndexOf(componentID);
+			return columnIndex != componentAllocInfos.size() ? AddressOfColumn(allocation, columnIndex) : nullptr;
+		}
+
+		/** Writable access of AddressOf, it stamps column of allocation with given version through same column lookup. */
+		[[nodiscard]] void* AddressOf(const Allocation allocation, const ComponentID componentID, const uint64_t version) noexcept
+		{
+			assert(allocation.ChunkIndex < chunks.size());
+			const size_t columnIndex = ColumnIndexOf(componentID);
+			if (columnIndex != componentAllocInfos.size())
+			{
+				StoreChangeVersion(allocation.ChunkIndex, columnIndex, version);
+				return AddressOfColumn(allocation, columnIndex);
+			}
+
+			return nullptr;
+		}
+
+		/** Return nullptr if chunk list does not have sub-column of field. */
+		[[nodiscard]] void* FieldAddressOf(const Allocation allocation, const ComponentID componentID, const size_t fieldIndex) const
+		{
+			assert(allocation.ChunkIndex < chunks.size());
+			const size_t columnIndex = ColumnIndexOf(componentID) + fieldIndex;
+			if (columnIndex < componentAllocInfos.size() && componentAllocInfos[columnIndex].ID == componentID && componentAllocInfos[columnIndex].FieldIndex == fieldIndex)
+			{
+				return ComponentRange::ComponentAddress(chunks[allocation.ChunkIndex].BaseAddress(), allocation.AllocationIndexOfEntity, componentAllocInfos[columnIndex].Range);
+			}
+
+			return nullptr;
+		}
+
+		/** Copy declared fields of component object into sub-columns of allocation. */
+		void ScatterFields(const Allocation allocation, const ComponentID componentID, const void* object) const
+		{
+			void* baseAddress = BaseAddressOf(allocation);
+			for (const ComponentAllocationInfo& info : FieldColumnsOf(componentID))
+			{
+				std::memcpy(ComponentRange::ComponentAddress(baseAddress, allocation.AllocationIndexOfEntity, info.Range), static_cast<const std::byte*>(object) + info.FieldOffset, info.Range.Size);
+			}
+		}
+
+		/** Copy sub-columns of allocation into declared fields of component object. */
+		void GatherFields(const Allocation allocation, const ComponentID componentID, void* object) const
+		{
+			const void* baseAddress = BaseAddressOf(allocation);
+			for (const ComponentAllocationInfo& info : FieldColumnsOf(componentID))
+			{
+				std::memcpy(static_cast<std::byte*>(object) + info.FieldOffset, ComponentRange::ComponentAddress(const_cast<void*>(baseAddress), allocation.AllocationIndexOfEntity, info.Range), info.Range.Size);
+			}
+		}
+
+		[[nodiscard]] bool IsChunkFull(const size_t chunkIndex) const noexcept
+		{
+			assert(chunkIndex < chunks.size());
+			return chunks.at(chunkIndex).IsFull();
+		}
+
+		[[nodiscard]] bool IsChunkEmpty(const size_t chunkIndex) const noexcept
+		{
+			assert(chunkIndex < chunks.size());
+			return chunks.at(chunkIndex).IsEmpty();
+		}
+
+		/**
+		* Stamp column of chunk with given version. It is safe to call concurrently with other MarkChanged and readers of versions,
+		* so writable accesses which only hold shared lock of archive can stamp versions.
+		*/
+		void MarkChanged(const size_t chunkIndex, const ComponentID componentID, const uint64_t version) noexcept
+		{
+			/** Sub-columns of field split component are always written together, so its version is kept in first sub-column. */
+			assert(chunkIndex < chunks.size());
+			const size_t columnIndex = ColumnIndexOf(componentID);
+			if (columnIndex != componentAllocInfos.size())
+			{
+				StoreChangeVersion(chunkIndex, columnIndex, version);
+			}
+		}
+
+		/** Stamp every columns of chunk with given version. */
+		void MarkChanged(const size_t chunkIndex, const uint64_t version) noexcept
+		{
+			assert(chunkIndex < chunks.size());
+			for (size_t columnIndex = 0; columnIndex < componentAllocInfos.size(); ++columnIndex)
+			{
+				StoreChangeVersion(chunkIndex, columnIndex, version);
+			}
+		}
+
+		/** Return version which column of chunk was written at last, 0 if chunk list does not support component. */
+		[[nodiscard]] uint64_t ChangeVersionOf(const size_t chunkIndex, const ComponentID componentID) const noexcept
+		{
+			assert(chunkIndex < chunks.size());
+			const size_t columnIndex = ColumnIndexOf(componentID);
+			if (columnIndex != componentAllocInfos.size())
+			{
+				return LoadChangeVersion(chunkIndex, columnIndex);
+			}
+
+			return 0;
+		}
+
+		/** Return true if any column of chunk was written after given version. */
+		[[nodiscard]] bool HasChangedSince(const size_t chunkIndex, const uint64_t version) const noexcept
+		{
+			assert(chunkIndex < chunks.size());
+			for (size_t columnIndex = 0; columnIndex < componentAllocInfos.size(); ++columnIndex)
+			{
+				if (LoadChangeVersion(chunkIndex, columnIndex) > version)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		[[nodiscard]] bool IsEnableable(const ComponentID componentID) const noexcept
+		{
+			return EnableableIndexOf(componentID) != enableableComponentIDs.size();
+		}
+
+		/** Component which is not enableable is always enabled, unsupported component is never enabled. */
+		[[nodiscard]] bool IsEnabled(const Allocation allocation, const ComponentID componentID) const noexcept
+		{
+			assert(allocation.ChunkIndex < chunks.size());
+			const size_t enableableIndex = EnableableIndexOf(componentID);
+			if (enableableIndex != enableableComponentIDs.size())
+			{
+				uint64_t& enabledMask = const_cast<uint64_t&>(EnabledMasksOf(allocation.ChunkIndex, enableableIndex)[allocation.AllocationIndexOfEntity / BITS_PER_ENABLED_MASK]);
+				return (std::atomic_ref<uint64_t>(enabledMask).load(std::memory_order_relaxed) & (uint64_t(1) << (allocation.AllocationIndexOfEntity % BITS_PER_ENABLED_MASK))) != 0;
+			}
+
+			return Support(componentID);
+		}
+
+		/**
+		* Flip enabled bit of component. Bits of same chunk can be flipped concurrently.
+		* @return	False if chunk list does not have enableable column of component.
+		*/
+		bool SetEnabled(const Allocation allocation, const ComponentID componentID, const bool bEnabled) noexcept
+		{
+			assert(allocation.ChunkIndex < chunks.size());
+			const size_t enableableIndex = EnableableIndexOf(componentID);
+			if (enableableIndex != enableableComponentIDs.size())
+			{
+				std::atomic_ref<uint64_t> enabledMask(EnabledMasksOf(allocation.ChunkIndex, enableableIndex)[allocation.AllocationIndexOfEntity / BITS_PER_ENABLED_MASK]);
+				const uint64_t enabledBit = uint64_t(1) << (allocation.AllocationIndexOfEntity % BITS_PER_ENABLED_MASK);
+				if (bEnabled)
+				{
+					enabledMask.fetch_or(enabledBit, std::memory_order_relaxed);
+				}
+				else
+				{
+					enabledMask.fetch_and(~enabledBit, std::memory_order_relaxed);
+				}
+
+				return true;
+			}
+
+			return false;
+		}
+
+		/** Bit per row which set when component of row is enabled, nullptr if component is not enableable. */
+		[[nodiscard]] const uint64_t* EnabledMaskOf(const size_t chunkIndex, const ComponentID componentID) const noexcept
+		{
+			assert(chunkIndex < chunks.size());
+			const size_t enableableIndex = EnableableIndexOf(componentID);
+			return enableableIndex != enableableComponentIDs.size() ? EnabledMasksOf(chunkIndex, enableableIndex) : nullptr;
+		}
+
+		[[nodiscard]] size_t NumOfEnabledMasksPerChunk() const noexcept { return numOfEnabledMasksPerChunk; }
+
+		/** Return value which every rows of chunk list share, nullptr if component is not shared component of chunk list. */
+		[[nodiscard]] const void* SharedValueOf(const ComponentID componentID) const noexcept
+		{
+			const auto found = std::find(sharedComponentIDs.cbegin(), sharedComponentIDs.cend(), componentID);
+			return found != sharedComponentIDs.cend() ? sharedValues[std::distance(sharedComponentIDs.cbegin(), found)] : nullptr;
+		}
+
+		[[nodiscard]] const std::vector<const void*>& SharedValues() const noexcept { return sharedValues; }
+		[[nodiscard]] std::span<const ComponentID> EnableableComponents() const noexcept { return enableableComponentIDs; }
+
+		/**
+		* Pick smallest chunk size class which can hold at least MIN_NUM_OF_ALLOCATIONS_PER_CHUNK rows, biggest size class if it holds at least one row.
+		* Otherwise archetype is oversized and gets chunk which fits exactly single row(rounded up to oversized chunk granularity).
+		*/
+		[[nodiscard]] static size_t SelectChunkSize(const std::vector<ComponentInfo>& componentInfos)
+		{
+			for (const size_t chunkSizeClass : CHUNK_SIZE_CLASSES)
+			{
+				if (ComputeLayout(componentInfos, chunkSizeClass).MaxNumOfAllocations >= MIN_NUM_OF_ALLOCATIONS_PER_CHUNK)
+				{
+					return chunkSizeClass;
+				}
+			}
+
+			if (ComputeLayout(componentInfos, CHUNK_SIZE_CLASSES.back()).MaxNumOfAllocations > 0)
+			{
+				return CHUNK_SIZE_CLASSES.back();
+			}
+
+			Layout singleRowLayout = ComputeLayout(componentInfos, std::numeric_limits<size_t>::max());
+			return ChunkAllocator::ActualChunkSize(PlaceColumns(singleRowLayout.ComponentAllocInfos, 1));
+		}
+
+		/**
+		* Columns are ordered by descending alignment and then packed with actual alignment of each components,
+		* so components which size is multiple of its alignment never need padding between columns.
+		* Column begin is padded to cache line only when it spans at least one cache line and padding doesn't cost any row.
+		*/
+		[[nodiscard]] static Layout ComputeLayout(const std::vector<ComponentInfo>& componentInfos, const size_t chunkSize)
+		{
+			Layout layout;
+			layout.ComponentAllocInfos.reserve(componentInfos.size());
+
+			size_t sizeOfRow = 0;
+			for (const ComponentInfo& info : componentInfos)
+			{
+				assert(std::has_single_bit(info.Alignment) && info.Alignment <= OVERSIZED_CHUNK_GRANULARITY && "Chunk memory can not honor given alignment.");
+				if (info.Fields.empty())
+				{
+					layout.ComponentAllocInfos.emplace_back(ComponentAllocationInfo
+						{
+							.Range = ComponentRange
+							{
+								.Offset = 0,
+								.Size = info.Size
+							},
+							.ID = info.ID,
+							.Alignment = info.Alignment,
+							.RelocateRange = info.RelocateRange
+						});
+					sizeOfRow += info.Size;
+				}
+				else
+				{
+					for (size_t fieldIndex = 0; fieldIndex < info.Fields.size(); ++fieldIndex)
+					{
+						const FieldInfo& field = info.Fields[fieldIndex];
+						layout.ComponentAllocInfos.emplace_back(ComponentAllocationInfo
+							{
+								.Range = ComponentRange
+								{
+									.Offset = 0,
+									.Size = field.Size
+								},
+								.ID = info.ID,
+								.Alignment = field.Alignment,
+								.FieldIndex = fieldIndex,
+								.FieldOffset = field.Offset
+							});
+						sizeOfRow += field.Size;
+					}
+				}
+			}
+
+			if (sizeOfRow == 0)
+			{
+				return layout;
+			}
+
+			std::stable_sort(layout.ComponentAllocInfos.begin(), layout.ComponentAllocInfos.end(), [](const ComponentAllocationInfo& lhs, const ComponentAllocationInfo& rhs)
+				{
+					return lhs.Alignment > rhs.Alignment;
+				});
+
+			size_t numOfRows = std::min(chunkSize / sizeOfRow, Chunk::MAX_NUM_OF_ALLOCATIONS);
+			while (numOfRows > 0 && PlaceColumns(layout.ComponentAllocInfos, numOfRows) > chunkSize)
+			{
+				--numOfRows;
+			}
+
+			layout.MaxNumOfAllocations = numOfRows;
+			if (numOfRows > 0)
+			{
+				for (ComponentAllocationInfo& info : layout.ComponentAllocInfos)
+				{
+					if (info.Alignment < CACHE_LINE && (info.Range.Size * numOfRows) >= CACHE_LINE)
+					{
+						const size_t componentAlignment = info.Alignment;
+						info.Alignment = CACHE_LINE;
+						if (PlaceColumns(layout.ComponentAllocInfos, numOfRows) > chunkSize)
+						{
+							info.Alignment = componentAlignment;
+						}
+					}
+				}
+			}
+
+			PlaceColumns(layout.ComponentAllocInfos, numOfRows);
+			return layout;
+		}
+
+		/**
+		* Owner entities of rows in chunk. Dense chunk list never has hole in span,
+		* sparse chunk list marks freed allocation as INVALID_ENTITY_HANDLE.
+		*/
+		[[nodiscard]] std::span<const Entity> EntitiesOf(const size_t chunkIndex) const
+		{
+			const Chunk& chunk = chunks.at(chunkIndex);
+			return std::span<const Entity>(EntitiesOf(chunk), storageMode == ChunkStorageMode::Dense ? chunk.NumOfAllocations() : chunk.Extent());
+		}
+
+		/** Return address of first component of column in chunk, nullptr if chunk list does not support component. */
+		[[nodiscard]] void* ColumnOf(const size_t chunkIndex, const ComponentID componentID) const
+		{
+			return AddressOf(Allocation{ .ChunkIndex = chunkIndex, .AllocationIndexOfEntity = 0 }, componentID);
+		}
+
+		/** Return address of first field of sub-column in chunk, nullptr if chunk list does not have sub-column of field. */
+		[[nodiscard]] void* FieldColumnOf(const size_t chunkIndex, const ComponentID componentID, const size_t fieldIndex) const
+		{
+			return FieldAddressOf(Allocation{ .ChunkIndex = chunkIndex, .AllocationIndexOfEntity = 0 }, componentID, fieldIndex);
+		}
+
+		[[nodiscard]] size_t ChunkSize() const noexcept { return chunkSize; }
+		[[nodiscard]] size_t MaxNumOfAllocationsPerChunk() const noexcept { return maxNumOfAllocationsPerChunk; }
+		/** False if chunk list belongs to null archetype or archetype which only has tag components, it can not create allocation. */
+		[[nodiscard]] bool HasStorage() const noexcept { return maxNumOfAllocationsPerChunk > 0; }
+		[[nodiscard]] size_t NumOfChunks() const noexcept { return chunks.size(); }
+		[[nodiscard]] size_t NumOfAllocations() const noexcept { return numOfAllocations; }
+		[[nodiscard]] size_t NumOfEntities() const noexcept { return HasStorage() ? numOfAllocations : entitiesWithoutStorage.size(); }
+		[[nodiscard]] ChunkStorageMode StorageMode() const noexcept { return storageMode; }
+		[[nodiscard]] std::span<const Entity> EntitiesWithoutStorage() const noexcept { return entitiesWithoutStorage; }
+
+		/** @return	Slot of entity in entities of chunk list which has no storage. */
+		size_t AddEntityWithoutStorage(const Entity entity)
+		{
+			assert(!HasStorage());
+			entitiesWithoutStorage.emplace_back(entity);
+			return entitiesWithoutStorage.size() - 1;
+		}
+
+		/** @return	Last entity which filled removed slot, INVALID_ENTITY_HANDLE if removed entity was last one. */
+		Entity RemoveEntityWithoutStorage(const size_t slot)
+		{
+			assert(!HasStorage() && slot < entitiesWithoutStorage.size());
+			const Entity movedEntity = entitiesWithoutStorage.back();
+			entitiesWithoutStorage[slot] = movedEntity;
+			entitiesWithoutStorage.pop_back();
+			return slot < entitiesWithoutStorage.size() ? movedEntity : INVALID_ENTITY_HANDLE;
+		}
+
+		/** Return lowest index of chunk which is not full, size of chunk list if every chunks are full. */
+		[[nodiscard]] size_t FreeChunkIndex() const noexcept
+		{
+			const size_t freeChunkIndex = nonFullChunks.FindFirst();
+			return freeChunkIndex == utils::HierarchicalBitset::NPOS ? chunks.size() : freeChunkIndex;
+		}
+
+		/** Ratio of allocated rows to rows of every chunks, 1 if chunk list has no chunk. */
+		[[nodiscard]] float FillRatio() const noexcept
+		{
+			return chunks.empty() ? 1.0f : static_cast<float>(numOfAllocations) / static_cast<float>(chunks.size() * maxNumOfAllocationsPerChunk);
+		}
+
+		/** Return size of chunk list if every chunks are empty. */
+		[[nodiscard]] size_t LastNonEmptyChunkIndex() const noexcept
+		{
+			for (size_t chunkIndex = chunks.size(); chunkIndex > 0; --chunkIndex)
+			{
+				if (!chunks[chunkIndex - 1].IsEmpty())
+				{
+					return chunkIndex - 1;
+				}
+			}
+
+			return chunks.size();
+		}
+
+		/** True if rows can be held by less chunks than chunk list has. */
+		[[nodiscard]] bool IsFragmented() const noexcept
+		{
+			return chunks.size() > ((numOfAllocations + maxNumOfAllocationsPerChunk - 1) / std::max<size_t>(maxNumOfAllocationsPerChunk, 1));
+		}
+
+		/**
+		* Move rows from tail chunks into free slots of head chunks until every chunks except last non-empty one are full.
+		* It never creates new chunk and never touches other chunk lists, so different chunk lists can be compacted concurrently.
+		* Chunks which receive rows are stamped with given version.
+		* @return	Entities which moved, owner of allocations must be updated by caller.
+		*/
+		std::vector<Relocation> Compact(const uint64_t version)
+		{
+			std::vector<Relocation> relocations;
+			for (size_t lastChunkIndex = LastNonEmptyChunkIndex(); lastChunkIndex < chunks.size() && FreeChunkIndex() < lastChunkIndex; lastChunkIndex = LastNonEmptyChunkIndex())
+			{
+				/** Last row of chunk is always occupied, in both of storage modes. */
+				const std::span<const Entity> entities = EntitiesOf(lastChunkIndex);
+				const Allocation srcAllocation{ .ChunkIndex = lastChunkIndex, .AllocationIndexOfEntity = entities.size() - 1 };
+				const Entity entity = entities.back();
+				const Allocation destAllocation = Create(entity);
+				MarkChanged(destAllocation.ChunkIndex, version);
+				const Entity movedEntity = MoveData(*this, srcAllocation, *this, destAllocation);
+				relocations.emplace_back(Relocation{ .Owner = entity, .NewAllocation = destAllocation });
+				if (movedEntity != INVALID_ENTITY_HANDLE)
+				{
+					relocations.emplace_back(Relocation{ .Owner = movedEntity, .NewAllocation = srcAllocation });
+				}
+			}
+
+			return relocations;
+		}
+
+		/**
+		* Return empty chunks at the end of chunk list to chunk allocator. Unlike ShrinkToFit, it never changes index of remaining chunks.
+		* @return	Number of released chunks.
+		*/
+		size_t ReleaseTrailingEmptyChunks()
+		{
+			size_t numOfRemainChunks = chunks.size();
+			while (numOfRemainChunks > 0 && chunks[numOfRemainChunks - 1].IsEmpty())
+			{
+				--numOfRemainChunks;
+			}
+
+			const size_t released = chunks.size() - numOfRemainChunks;
+			if (released > 0)
+			{
+				chunks.erase(chunks.begin() + numOfRemainChunks, chunks.end());
+				changeVersions.resize(numOfRemainChunks * componentAllocInfos.size());
+				enabledMasks.resize(numOfRemainChunks * enableableComponentIDs.size() * numOfEnabledMasksPerChunk);
+				nonFullChunks.Resize(numOfRemainChunks);
+			}
+
+			return released;
+		}
+
+		/**
+		* Return every chunks to chunk allocator at once, it doesn't call any destructor.
+		* @return	Number of released chunks.
+		*/
+		size_t Clear()
+		{
+			const size_t released = chunks.size();
+			chunks.clear();
+			changeVersions.clear();
+			enabledMasks.clear();
+			nonFullChunks.Resize(0);
+			numOfAllocations = 0;
+			entitiesWithoutStorage.clear();
+			return released;
+		}
+
+		size_t ShrinkToFit()
+		{
+			/** Compact chunks, their change versions and enabled masks together. */
+			const size_t numOfColumns = componentAllocInfos.size();
+			const size_t numOfEnabledMasks = enableableComponentIDs.size() * numOfEnabledMasksPerChunk;
+			size_t numOfRemainChunks = 0;
+			for (size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+			{
+				if (!chunks[chunkIndex].IsEmpty())
+				{
+					if (numOfRemainChunks != chunkIndex)
+					{
+						chunks[numOfRemainChunks] = std::move(chunks[chunkIndex]);
+						std::copy_n(changeVersions.cbegin() + (chunkIndex * numOfColumns), numOfColumns, changeVersions.begin() + (numOfRemainChunks * numOfColumns));
+						std::copy_n(enabledMasks.cbegin() + (chunkIndex * numOfEnabledMasks), numOfEnabledMasks, enabledMasks.begin() + (numOfRemainChunks * numOfEnabledMasks));
+					}
+
+					++numOfRemainChunks;
+				}
+			}
+
+			const size_t reduced = chunks.size() - numOfRemainChunks;
+			chunks.erase(chunks.begin() + numOfRemainChunks, chunks.end());
+			changeVersions.resize(numOfRemainChunks * numOfColumns);
+			enabledMasks.resize(numOfRemainChunks * numOfEnabledMasks);
+			chunks.shrink_to_fit();
+			changeVersions.shrink_to_fit();
+			enabledMasks.shrink_to_fit();
+			RebuildNonFullChunkIndex();
+			return reduced;
+		}
+
+		[[nodiscard]] static TransferPlan BuildTransferPlan(const ChunkList& srcChunkList, const ChunkList& destChunkList)
+		{
+			TransferPlan plan;
+			for (const ComponentAllocationInfo& srcComponentAllocInfo : srcChunkList.componentAllocInfos)
+			{
+				for (const ComponentAllocationInfo& destComponentAllocInfo : destChunkList.componentAllocInfos)
+				{
+					if (srcComponentAllocInfo.ID == destComponentAllocInfo.ID && srcComponentAllocInfo.FieldIndex == destComponentAllocInfo.FieldIndex)
+					{
+						assert(srcComponentAllocInfo.Range.Size == destComponentAllocInfo.Range.Size);
+						plan.Columns.emplace_back(TransferPlan::ColumnTransfer{
+							.SrcOffset = srcComponentAllocInfo.Range.Offset,
+							.DestOffset = destComponentAllocInfo.Range.Offset,
+							.Size = srcComponentAllocInfo.Range.Size,
+							.RelocateRange = srcComponentAllocInfo.RelocateRange });
+					}
+				}
+			}
+
+			for (size_t srcEnableableIndex = 0; srcEnableableIndex < srcChunkList.enableableComponentIDs.size(); ++srcEnableableIndex)
+			{
+				const size_t destEnableableIndex = destChunkList.EnableableIndexOf(srcChunkList.enableableComponentIDs[srcEnableableIndex]);
+				if (destEnableableIndex != destChunkList.enableableComponentIDs.size())
+				{
+					plan.EnabledMasks.emplace_back(srcEnableableIndex, destEnableableIndex);
+				}
+			}
+
+			return plan;
+		}
+
+		/**
+		* Relocate components of row, trivially relocatable components are copied as raw memory and others are moved through their move constructor.
+		* Plan must be built from same source and destination chunk list.
+		* @return	Entity which moved into source allocation to keep source chunk dense, INVALID_ENTITY_HANDLE if nothing moved.
+		*/
+		static Entity MoveData(ChunkList& srcChunkList, const Allocation srcAllocation, ChunkList& destChunkList, const Allocation destAllocation, const TransferPlan& plan)
+		{
+			bool bIsValid = !srcAllocation.IsFailedToAllocate() && !destAllocation.IsFailedToAllocate();
+			assert(bIsValid);
+
+			bIsValid = bIsValid && (srcAllocation.ChunkIndex < srcChunkList.chunks.size() && destAllocation.ChunkIndex < destChunkList.chunks.size());
+			assert(bIsValid);
+
+			if (bIsValid)
+			{
+				void* srcAddress = srcChunkList.BaseAddressOf(srcAllocation);
+				void* destAddress = destChunkList.BaseAddressOf(destAllocation);
+				for (const TransferPlan::ColumnTransfer& column : plan.Columns)
+				{
+					ComponentRange::ComponentRelocate(
+						destAddress, srcAddress, destAllocation.AllocationIndexOfEntity, srcAllocation.AllocationIndexOfEntity,
+						ComponentRange{ .Offset = column.DestOffset, .Size = column.Size }, ComponentRange{ .Offset = column.SrcOffset, .Size = column.Size },
+						column.RelocateRange);
+				}
+
+				for (const auto& [srcEnableableIndex, destEnableableIndex] : plan.EnabledMasks)
+				{
+					CopyEnabledBit(
+						destChunkList.EnabledMasksOf(destAllocation.ChunkIndex, destEnableableIndex), destAllocation.AllocationIndexOfEntity,
+						srcChunkList.EnabledMasksOf(srcAllocation.ChunkIndex, srcEnableableIndex), srcAllocation.AllocationIndexOfEntity);
+				}
+
+				return srcChunkList.Destroy(srcAllocation);
+			}
+
+			return INVALID_ENTITY_HANDLE;
+		}
+
+		/**
+		* Relocate consecutive rows of source chunk into consecutive rows of destination chunk as single range per column.
+		* Source rows are left destroyed but not freed.
+		* Plan must be built from same source and destination chunk list.
+		*/
+		static void RelocateRows(ChunkList& srcChunkList, const Allocation srcFirst, ChunkList& destChunkList, const Allocation destFirst, const size_t numOfRows, const TransferPlan& plan) noexcept
+		{
+			void* srcAddress = srcChunkList.BaseAddressOf(srcFirst);
+			void* destAddress = destChunkList.BaseAddressOf(destFirst);
+			for (const TransferPlan::ColumnTransfer& column : plan.Columns)
+			{
+				ComponentRange::ComponentRelocate(
+					destAddress, srcAddress, destFirst.AllocationIndexOfEntity, srcFirst.AllocationIndexOfEntity,
+					ComponentRange{ .Offset = column.DestOffset, .Size = column.Size }, ComponentRange{ .Offset = column.SrcOffset, .Size = column.Size },
+					column.RelocateRange, numOfRows);
+			}
+
+			for (const auto& [srcEnableableIndex, destEnableableIndex] : plan.EnabledMasks)
+			{
+				uint64_t* destMasks = destChunkList.EnabledMasksOf(destFirst.ChunkIndex, destEnableableIndex);
+				const uint64_t* srcMasks = srcChunkList.EnabledMasksOf(srcFirst.ChunkIndex, srcEnableableIndex);
+				for (size_t row = 0; row < numOfRows; ++row)
+				{
+					CopyEnabledBit(destMasks, destFirst.AllocationIndexOfEntity + row, srcMasks, srcFirst.AllocationIndexOfEntity + row);
+				}
+			}
+		}
+
+		/** Plan is built for each call, except moving inside of single chunk list. */
+		static Entity MoveData(ChunkList& srcChunkList, const Allocation srcAllocation, ChunkList& destChunkList, const Allocation destAllocation)
+		{
+			if (&srcChunkList == &destChunkList)
+			{
+				return MoveData(srcChunkList, srcAllocation, destChunkList, destAllocation, srcChunkList.selfTransferPlan);
+			}
+
+			return MoveData(srcChunkList, srcAllocation, destChunkList, destAllocation, BuildTransferPlan(srcChunkList, destChunkList));
+		}
+
+	private:
+		[[nodiscard]] Entity* EntitiesOf(const Chunk& chunk) const noexcept
+		{
+			return static_cast<Entity*>(ComponentRange::ComponentAddress(chunk.BaseAddress(), 0, entityRange));
+		}
+
+		/** Return size of component allocation infos if chunk list does not support component. */
+		[[nodiscard]] size_t ColumnIndexOf(const ComponentID componentID) const noexcept
+		{
+			return componentID < columnIndexLUT.size() ? columnIndexLUT[componentID] : componentAllocInfos.size();
+		}
+
+		/** Sub-columns of field split component in field order, empty if component is not field split or chunk list does not support it. */
+		[[nodiscard]] std::span<const ComponentAllocationInfo> FieldColumnsOf(const ComponentID componentID) const noexcept
+		{
+			const size_t firstColumnIndex = ColumnIndexOf(componentID);
+			size_t endColumnIndex = firstColumnIndex;
+			while (endColumnIndex < componentAllocInfos.size() && componentAllocInfos[endColumnIndex].ID == componentID && componentAllocInfos[endColumnIndex].FieldIndex != WHOLE_COMPONENT)
+			{
+				++endColumnIndex;
+			}
+
+			return std::span<const ComponentAllocationInfo>(componentAllocInfos).subspan(firstColumnIndex, endColumnIndex - firstColumnIndex);
+		}
+
+		/** Return nullptr if column is sub-column of field split component, because its object does not live in chunk. */
+		[[nodiscard]] void* AddressOfColumn(const Allocation allocation, const size_t columnIndex) const noexcept
+		{
+			const ComponentAllocationInfo& allocInfo = componentAllocInfos[columnIndex];
+			if (allocInfo.FieldIndex != WHOLE_COMPONENT)
+			{
+				return nullptr;
+			}
+
+			return static_cast<std::byte*>(chunks[allocation.ChunkIndex].BaseAddress()) + allocInfo.Range.Offset + (allocation.AllocationIndexOfEntity * allocInfo.Range.Size);
+		}
+
+		/** Enableable components are enabled by default. */
+		void EnableRows(const Allocation first, const size_t numOfRows) noexcept
+		{
+			const size_t endOfRows = first.AllocationIndexOfEntity + numOfRows;
+			for (size_t enableableIndex = 0; enableableIndex < enableableComponentIDs.size(); ++enableableIndex)
+			{
+				uint64_t* masks = EnabledMasksOf(first.ChunkIndex, enableableIndex);
+				for (size_t row = first.AllocationIndexOfEntity; row < endOfRows;)
+				{
+					const size_t bitIndex = row % BITS_PER_ENABLED_MASK;
+					const size_t numOfBits = std::min(BITS_PER_ENABLED_MASK - bitIndex, endOfRows - row);
+					const uint64_t bits = numOfBits == BITS_PER_ENABLED_MASK ? ~uint64_t(0) : ((uint64_t(1) << numOfBits) - 1);
+					masks[row / BITS_PER_ENABLED_MASK] |= bits << bitIndex;
+					row += numOfBits;
+				}
+			}
+		}
+
+		[[nodiscard]] size_t EnableableIndexOf(const ComponentID componentID) const noexcept
+		{
+			return std::distance(enableableComponentIDs.cbegin(), std::find(enableableComponentIDs.cbegin(), enableableComponentIDs.cend(), componentID));
+		}
+
+		[[nodiscard]] uint64_t* EnabledMasksOf(const size_t chunkIndex, const size_t enableableIndex) noexcept
+		{
+			return enabledMasks.data() + (((chunkIndex * enableableComponentIDs.size()) + enableableIndex) * numOfEnabledMasksPerChunk);
+		}
+
+		[[nodiscard]] const uint64_t* EnabledMasksOf(const size_t chunkIndex, const size_t enableableIndex) const noexcept
+		{
+			return enabledMasks.data() + (((chunkIndex * enableableComponentIDs.size()) + enableableIndex) * numOfEnabledMasksPerChunk);
+		}
+
+		static void CopyEnabledBit(uint64_t* destMasks, const size_t destIndex, const uint64_t* srcMasks, const size_t srcIndex) noexcept
+		{
+			const uint64_t destBit = uint64_t(1) << (destIndex % BITS_PER_ENABLED_MASK);
+			const bool bIsSrcEnabled = (srcMasks[srcIndex / BITS_PER_ENABLED_MASK] & (uint64_t(1) << (srcIndex % BITS_PER_ENABLED_MASK))) != 0;
+			destMasks[destIndex / BITS_PER_ENABLED_MASK] = bIsSrcEnabled ?
+				(destMasks[destIndex / BITS_PER_ENABLED_MASK] | destBit) :
+				(destMasks[destIndex / BITS_PER_ENABLED_MASK] & ~destBit);
+		}
+
+		[[nodiscard]] uint64_t LoadChangeVersion(const size_t chunkIndex, const size_t columnIndex) const noexcept
+		{
+			/** Version may be stamped concurrently by writable accesses, atomic_ref to const is not allowed until C++26. */
+			uint64_t& changeVersion = const_cast<uint64_t&>(changeVersions[(chunkIndex * componentAllocInfos.size()) + columnIndex]);
+			return std::atomic_ref<uint64_t>(changeVersion).load(std::memory_order_relaxed);
+		}
+
+		void StoreChangeVersion(const size_t chunkIndex, const size_t columnIndex, const uint64_t version) noexcept
+		{
+			std::atomic_ref<uint64_t>(changeVersions[(chunkIndex * componentAllocInfos.size()) + columnIndex]).store(version, std::memory_order_relaxed);
+		}
+
+		/** Place columns in order with its alignment. Return end offset of last column. */
+		static size_t PlaceColumns(std::vector<ComponentAllocationInfo>& allocInfos, const size_t numOfRows) noexcept
+		{
+			size_t offset = 0;
+			for (ComponentAllocationInfo& info : allocInfos)
+			{
+				offset += utils::AlignForwardAdjustment(offset, info.Alignment);
+				info.Range.Offset = offset;
+				offset += info.Range.Size * numOfRows;
+			}
+
+			return offset;
+		}
+
+		void RebuildNonFullChunkIndex()
+		{
+			nonFullChunks.Resize(chunks.size());
+			nonFullChunks.Clear();
+			for (size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+			{
+				if (!chunks[chunkIndex].IsFull())
+				{
+					nonFullChunks.Set(chunkIndex);
+				}
+			}
+		}
+
+	private:
+		ChunkAllocator* chunkAllocator;
+		std::vector<Chunk> chunks;
+		/** Bit is set when chunk at same index has at least one free slot. */
+		utils::HierarchicalBitset nonFullChunks;
+		std::vector<ComponentAllocationInfo> componentAllocInfos;
+		/** Column index in component allocation infos indexed by component ID, size of component allocation infos if component is not supported. */
+		std::vector<size_t> columnIndexLUT;
+		ComponentRange entityRange;
+		size_t sizeOfData;
+		size_t chunkSize;
+		size_t maxNumOfAllocationsPerChunk;
+		size_t numOfAllocations = 0;
+		ChunkStorageMode storageMode;
+		std::vector<ComponentID> sharedComponentIDs;
+		/** Shared values are owned by archive, and their address identifies value. */
+		std::vector<const void*> sharedValues;
+		/** Version of last write to each columns, laid out as [chunk index * number of columns + column index]. */
+		std::vector<uint64_t> changeVersions;
+		std::vector<ComponentID> enableableComponentIDs;
+		size_t numOfEnabledMasksPerChunk = 0;
+		/** Enabled bit of each rows, laid out as [(chunk index * number of enableable components + enableable index) * masks per chunk + row / 64]. */
+		std::vector<uint64_t> enabledMasks;
+		/** Plan to move row to other row of same chunk list. */
+		TransferPlan selfTransferPlan;
+		/** Entities of chunk list which has no storage, they have no row so they are kept in single array. */
+		std::vector<Entity> entitiesWithoutStorage;
+
+	};
+
+	/**
+	* Rows of single chunk which visited by chunk iteration of archive.
+	* Column and Field are read-only access, only ColumnMut and FieldMut stamp change version of column.
+	*/
+	class ChunkView
+	{
+	public:
+		/** @param	enabledRowMask	Bit per row which set when every enableable filter components of row are enabled, nullptr if every rows are enabled. */
+		ChunkView(ChunkList& chunkList, const size_t chunkIndex, const uint64_t version, const uint64_t* enabledRowMask = nullptr) noexcept :
+			chunkList(chunkList),
+			chunkIndex(chunkIndex),
+			version(version),
+			enabledRowMask(enabledRowMask)
+		{
+		}
+
+		/** Sparse chunk list marks hole as INVALID_ENTITY_HANDLE, so skip those rows. */
+		[[nodiscard]] std::span<const Entity> Entities() const { return chunkList.EntitiesOf(chunkIndex); }
+
+		template <ComponentType T>
+		[[nodiscard]] T* ColumnMut()
+		{
+			static_assert(!IS_TAG_COMPONENT<T>, "Tag component has no column.");
+			chunkList.MarkChanged(chunkIndex, QueryComponentID<T>(), version);
+			return static_cast<T*>(chunkList.ColumnOf(chunkIndex, QueryComponentID<T>()));
+		}
+
+		template <ComponentType T>
+		[[nodiscard]] const T* Column() const
+		{
+			static_assert(!IS_TAG_COMPONENT<T>, "Tag component has no column.");
+			return static_cast<const T*>(chunkList.ColumnOf(chunkIndex, QueryComponentID<T>()));
+		}
+
+		/** Sub-column of declared field of field split component, it has same length as Entities. */
+		template <auto Member>
+		[[nodiscard]] std::span<FieldTypeOf<Member>> FieldMut()
+		{
+			const ComponentID componentID = QueryComponentID<FieldOwnerOf<Member>>();
+			chunkList.MarkChanged(chunkIndex, componentID, version);
+			return std::span<FieldTypeOf<Member>>(static_cast<FieldTypeOf<Member>*>(chunkList.FieldColumnOf(chunkIndex, componentID, FieldIndexOf<Member>())), Entities().size());
+		}
+
+		template <auto Member>
+		[[nodiscard]] std::span<const FieldTypeOf<Member>> Field() const
+		{
+			const ComponentID componentID = QueryComponentID<FieldOwnerOf<Member>>();
+			return std::span<const FieldTypeOf<Member>>(static_cast<const FieldTypeOf<Member>*>(chunkList.FieldColumnOf(chunkIndex, componentID, FieldIndexOf<Member>())), Entities().size());
+		}
+
+		/** Value of shared component which every rows of chunk share. */
+		template <SharedComponentType T>
+		[[nodiscard]] const T* Shared() const noexcept
+		{
+			return static_cast<const T*>(chunkList.SharedValueOf(QueryComponentID<T>()));
+		}
+
+		template <ComponentType T>
+		[[nodiscard]] uint64_t ChangeVersion() const noexcept
+		{
+			return chunkList.ChangeVersionOf(chunkIndex, QueryComponentID<T>());
+		}
+
+		/** Return true if every enableable filter components of row are enabled. It does not check holes of sparse chunk. */
+		[[nodiscard]] bool IsEnabled(const size_t row) const noexcept
+		{
+			return enabledRowMask == nullptr || (enabledRowMask[row / std::numeric_limits<uint64_t>::digits] & (uint64_t(1) << (row % std::numeric_limits<uint64_t>::digits))) != 0;
+		}
+
+		[[nodiscard]] size_t ChunkIndex() const noexcept { return chunkIndex; }
+
+	private:
+		ChunkList& chunkList;
+		const size_t chunkIndex;
+		const uint64_t version;
+		const uint64_t* enabledRowMask;
+
+	};
+
+	using Archetype = std::set<ComponentID>;
+
+	/**
+	* Compact identity of archetype. It is fixed-width bitset indexed by dense component ID with hash which precomputed from it,
+	* so archetypes can be found through hash map and compared as few words without chasing nodes of Archetype.
+	*/
+	class ArchetypeSignature
+	{
+	private:
+		using Word = uint64_t;
+		static constexpr size_t BITS_PER_WORD = std::numeric_limits<Word>::digits;
+		static constexpr size_t NUM_OF_WORDS = (MAX_NUM_OF_COMPONENTS + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+	public:
+		/** Visits component IDs of signature in ascending order. */
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = ComponentID;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const ComponentID*;
+			using reference = ComponentID;
+
+			Iterator() noexcept = default;
+			Iterator(const ArchetypeSignature& signature, const size_t bitIndex) noexcept :
+				signature(&signature),
+				bitIndex(signature.NextBitFrom(bitIndex))
+			{
+			}
+
+			[[nodiscard]] ComponentID operator*() const noexcept { return static_cast<ComponentID>(bitIndex); }
+
+			Iterator& operator++() noexcept
+			{
+				bitIndex = signature->NextBitFrom(bitIndex + 1);
+				return *this;
+			}
+
+			Iterator operator++(int) noexcept
+			{
+				Iterator result = *this;
+				++(*this);
+				return result;
+			}
+
+			[[nodiscard]] bool operator==(const Iterator& rhs) const noexcept { return bitIndex == rhs.bitIndex; }
+
+		private:
+			const ArchetypeSignature* signature = nullptr;
+			size_t bitIndex = MAX_NUM_OF_COMPONENTS;
+
+		};
+
+	public:
+		ArchetypeSignature() = default;
+		explicit ArchetypeSignature(const Archetype& archetype)
+		{
+			for (const ComponentID componentID : archetype)
+			{
+				Set(componentID);
+			}
+
+			UpdateHash();
+		}
+
+		/** Return signature which also has given component. */
+		[[nodiscard]] ArchetypeSignature With(const ComponentID componentID) const
+		{
+			ArchetypeSignature result = *this;
+			result.Set(componentID);
+			result.UpdateHash();
+			return result;
+		}
+
+		/** Return signature which does not have given component. */
+		[[nodiscard]] ArchetypeSignature Without(const ComponentID componentID) const
+		{
+			assert(componentID < MAX_NUM_OF_COMPONENTS);
+			ArchetypeSignature result = *this;
+			result.words[componentID / BITS_PER_WORD] &= ~(Word(1) << (componentID % BITS_PER_WORD));
+			result.UpdateHash();
+			return result;
+		}
+
+		[[nodiscard]] bool Contains(const ComponentID componentID) const noexcept
+		{
+			return componentID < MAX_NUM_OF_COMPONENTS && (words[componentID / BITS_PER_WORD] & (Word(1) << (componentID % BITS_PER_WORD))) != 0;
+		}
+
+		/** Return true if signature has every components of filter. */
+		[[nodiscard]] bool Includes(const Archetype& filter) const noexcept
+		{
+			return std::all_of(filter.cbegin(), filter.cend(), [this](const ComponentID componentID) { return Contains(componentID); });
+		}
+
+		[[nodiscard]] bool Includes(const ArchetypeSignature& filter) const noexcept
+		{
+			for (size_t wordIndex = 0; wordIndex < NUM_OF_WORDS; ++wordIndex)
+			{
+				if ((words[wordIndex] & filter.words[wordIndex]) != filter.words[wordIndex])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] Archetype ToArchetype() const { return Archetype(begin(), end()); }
+
+		[[nodiscard]] bool IsEmpty() const noexcept { return Size() == 0; }
+
+		[[nodiscard]] size_t Size() const noexcept
+		{
+			size_t size = 0;
+			for (const Word word : words)
+			{
+				size += std::popcount(word);
+			}
+
+			return size;
+		}
+
+		[[nodiscard]] size_t Hash() const noexcept { return hash; }
+		[[nodiscard]] Iterator begin() const noexcept { return Iterator(*this, 0); }
+		[[nodiscard]] Iterator end() const noexcept { return Iterator(*this, MAX_NUM_OF_COMPONENTS); }
+
+		[[nodiscard]] bool operator==(const ArchetypeSignature& rhs) const noexcept
+		{
+			return hash == rhs.hash && words == rhs.words;
+		}
+
+	private:
+		void Set(const ComponentID componentID) noexcept
+		{
+			assert(componentID < MAX_NUM_OF_COMPONENTS);
+			words[componentID / BITS_PER_WORD] |= Word(1) << (componentID % BITS_PER_WORD);
+		}
+
+		void UpdateHash() noexcept
+		{
+			hash = robin_hood::hash_bytes(words.data(), sizeof(words));
+		}
+
+		/** Return MAX_NUM_OF_COMPONENTS if there is no set bit at or after given bit. */
+		[[nodiscard]] size_t NextBitFrom(const size_t bitIndex) const noexcept
+		{
+			size_t wordIndex = bitIndex / BITS_PER_WORD;
+			if (wordIndex >= NUM_OF_WORDS)
+			{
+				return MAX_NUM_OF_COMPONENTS;
+			}
+
+			Word word = words[wordIndex] & (~Word(0) << (bitIndex % BITS_PER_WORD));
+			while (word == 0)
+			{
+				if (++wordIndex == NUM_OF_WORDS)
+				{
+					return MAX_NUM_OF_COMPONENTS;
+				}
+
+				word = words[wordIndex];
+			}
+
+			return std::min((wordIndex * BITS_PER_WORD) + std::countr_zero(word), MAX_NUM_OF_COMPONENTS);
+		}
+
+	private:
+		std::array<Word, NUM_OF_WORDS> words = {};
+		size_t hash = robin_hood::hash_bytes(words.data(), sizeof(words));
+
+	};
+
+	/**
+	* @brief	ComponentArchive itself guarantee thread-safety when SY_ECS_THREAD_SAFE is true. But write to component data which stored inside of chunk is not a thread-safe.
+	*/
+	class ComponentArchive
+	{
+	public:
+		struct SharedValue
+		{
+			void* Data = nullptr;
+			/** Number of entities which share value. */
+			size_t RefCount = 0;
+		};
+
+		/**
+		* Location of entity packed into 32 bit archetype index, 32 bit chunk index and 16 bit row, so entity record takes 16 bytes with its generation.
+		* Row of chunk fits in 16 bit since chunk holds at most Chunk::MAX_NUM_OF_ALLOCATIONS rows.
+		*/
+		struct ArchetypeData
+		{
+			static constexpr uint32_t INVALID_CHUNK_INDEX = std::numeric_limits<uint32_t>::max();
+			static constexpr uint16_t INVALID_ROW = std::numeric_limits<uint16_t>::max();
+			static_assert(Chunk::MAX_NUM_OF_ALLOCATIONS <= INVALID_ROW);
+
+			uint32_t ArchetypeIndex = 0;
+			uint32_t ChunkIndex = INVALID_CHUNK_INDEX;
+			uint16_t Row = INVALID_ROW;
+
+			[[nodiscard]] static ArchetypeData Pack(const size_t archetypeIndex, const ChunkList::Allocation allocation = {}) noexcept
+			{
+				assert(archetypeIndex <= std::numeric_limits<uint32_t>::max());
+				ArchetypeData result{ .ArchetypeIndex = static_cast<uint32_t>(archetypeIndex) };
+				result.SetAllocation(allocation);
+				return result;
+			}
+
+			[[nodiscard]] ChunkList::Allocation Allocation() const noexcept
+			{
+				if (ChunkIndex == INVALID_CHUNK_INDEX || Row == INVALID_ROW)
+				{
+					return ChunkList::Allocation();
+				}
+
+				return ChunkList::Allocation{ .ChunkIndex = ChunkIndex, .AllocationIndexOfEntity = Row };
+			}
+
+			void SetAllocation(const ChunkList::Allocation allocation) noexcept
+			{
+				if (allocation.IsFailedToAllocate())
+				{
+					ChunkIndex = INVALID_CHUNK_INDEX;
+					Row = INVALID_ROW;
+					return;
+				}
+
+				assert(allocation.ChunkIndex < INVALID_CHUNK_INDEX && allocation.AllocationIndexOfEntity < INVALID_ROW);
+				ChunkIndex = static_cast<uint32_t>(allocation.ChunkIndex);
+				Row = static_cast<uint16_t>(allocation.AllocationIndexOfEntity);
+			}
+
+			/** Entity of chunk list which has no storage has no row, so chunk index holds its slot in entities of chunk list instead. */
+			[[nodiscard]] size_t SlotWithoutStorage() const noexcept { return ChunkIndex; }
+
+			void SetSlotWithoutStorage(const size_t slot) noexcept
+			{
+				assert(slot < INVALID_CHUNK_INDEX);
+				ChunkIndex = static_cast<uint32_t>(slot);
+				Row = INVALID_ROW;
+			}
+		};
+
+		/** Archetype index of record whose entity never had any component, or is destroyed. */
+		static constexpr uint32_t NO_ARCHETYPE = std::numeric_limits<uint32_t>::max();
+
+		/** Generation is issued by thread which owns index without any lock, rest of record is only touched by archive operations. */
+		struct EntityRecord
+		{
+			/** Generation of handle which currently owns record, UNISSUED_ENTITY_GENERATION until handle of its index is issued. */
+			std::atomic<EntityGeneration> Generation = UNISSUED_ENTITY_GENERATION;
+			ArchetypeData Data{ .ArchetypeIndex = NO_ARCHETYPE };
+		};
+		static_assert(sizeof(EntityRecord) == 16);
+
+		/** Records are allocated page by page and pages never move, so thread can issue its own records while other thread allocates new page. */
+		static constexpr size_t ENTITY_RECORDS_PER_PAGE = size_t(1) << 16;
+		static constexpr size_t NUM_OF_ENTITY_RECORD_PAGES = (size_t(std::numeric_limits<EntityIndex>::max()) + 1) / ENTITY_RECORDS_PER_PAGE;
+
+		/** Number of entity indices which thread reserves from global source at once. */
+		static constexpr size_t ENTITY_RESERVATION_BLOCK_SIZE = 1024;
+
+		/**
+		* Entity handles which are owned by single thread, so creating and recycling entity does not touch any shared state until block runs out.
+		* Handles which are left at thread exit are returned to global pool.
+		*/
+		struct EntityReservation
+		{
+			uint64_t NextIndex = 0;
+			uint64_t EndIndex = 0;
+			/** Handles of destroyed entities with their next generation, reused in LIFO order. */
+			std::vector<Entity> Recycled;
+
+			/** Thread may exit while or after archive is destroyed, so instance is checked under lock which DestroyInstance also takes. */
+			~EntityReservation()
+			{
+				std::lock_guard lock{ instanceLifetimeMutex };
+				if (instance != nullptr)
+				{
+					instance->ReturnReservation(*this);
+				}
+			}
+		};
+
+		/** Cached transition from chunk list to other chunk list, made by attaching or detaching single component. */
+		struct ArchetypeEdge
+		{
+			size_t TargetChunkListIndex = 0;
+			ChunkList::TransferPlan Plan;
+		};
+
+		/** Outgoing transitions of chunk list. Shared component is not cached, because target depends on its value. */
+		struct ArchetypeEdges
+		{
+			robin_hood::unordered_flat_map<ComponentID, ArchetypeEdge> Attach;
+			robin_hood::unordered_flat_map<ComponentID, ArchetypeEdge> Detach;
+			/** Plans to chunk lists which reached by changing several components at once, keyed by target chunk list index. */
+			robin_hood::unordered_flat_map<size_t, ChunkList::TransferPlan> Jump;
+		};
+
+		/** Chunk list is identified by archetype and values of its shared components. */
+		struct ChunkListKey
+		{
+			ArchetypeSignature Signature;
+			std::vector<const void*> SharedValues;
+
+			[[nodiscard]] bool operator==(const ChunkListKey&) const noexcept = default;
+		};
+
+		struct ChunkListKeyHash
+		{
+			[[nodiscard]] size_t operator()(const ChunkListKey& key) const noexcept
+			{
+				size_t hash = key.Signature.Hash();
+				for (const void* sharedValue : key.SharedValues)
+				{
+					hash = utils::CombineHash(hash, robin_hood::hash_int(reinterpret_cast<uintptr_t>(sharedValue)));
+				}
+
+				return hash;
+			}
+		};
+
+		struct DefragmentationStepResult
+		{
+			size_t NumOfMovedEntities = 0;
+			/** Chunks which returned to chunk allocator. */
+			size_t NumOfFreedChunks = 0;
+			size_t FreedBytes = 0;
+			/** True if there is no fragmented archetype left. */
+			bool bIsCompleted = false;
+		};
+
+		template <ComponentType T>
+		class ComponentHandle
+		{
+		public:
+			ComponentHandle(ComponentArchive& archive, const Entity entity) noexcept :
+				archive(archive),
+				entity(entity)
+			{
+			}
+
+			~ComponentHandle() = default;
+
+			ComponentHandle(const ComponentHandle&) noexcept = default;
+			ComponentHandle(ComponentHandle&&) noexcept = default;
+			ComponentHandle& operator=(const ComponentHandle&) noexcept = default;
+			ComponentHandle& operator=(ComponentHandle&&) noexcept = default;
+
+			/** Read-only access, it does not change version of component. */
+			const T& operator*() const { return Reference(); }
+			const T* operator->() const { return std::as_const(archive).Get<T>(entity); }
+			const T& Reference() const { return *std::as_const(archive).Get<T>(entity); }
+
+			/** Writable access, it stamps component with current version. */
+			[[nodiscard]] T* GetMut() { return archive.GetMut<T>(entity); }
+
+			[[nodiscard]] Entity Owner() const noexcept { return entity; }
+			[[nodiscard]] bool IsValid() const noexcept { return archive.Contains<T>(entity); }
+			[[nodiscard]] ComponentID ID() const noexcept { return QueryComponentID<T>(); }
+
+		private:
+			ComponentArchive& archive;
+			const Entity entity;
+
+		};
+
+#if SY_ECS_THREAD_SAFE
+		using Mutex_t = std::shared_timed_mutex;
+		using WriteLock_t = std::unique_lock<Mutex_t>;
+		using ReadOnlyLock_t = std::shared_lock<Mutex_t>;
+#endif
+
+	public:
+		ComponentArchive(const ComponentArchive&) = delete;
+		ComponentArchive(ComponentArchive&&) = delete;
+		ComponentArchive& operator=(const ComponentArchive&) = delete;
+		ComponentArchive& operator=(ComponentArchive&&) = delete;
+
+		/** Remaining entities are destroyed whole chunk list at a time. */
+		~ComponentArchive() noexcept(false)
+		{
+			DestroyAll(Archetype());
+		}
+
+		static ComponentArchive& Instance()
+		{
+			std::call_once(instanceCreationOnceFlag, []()
+				{
+					instance.reset(new ComponentArchive());
+				});
+
+			return *instance;
+		}
+
+		[[nodiscard]] ChunkAllocator& ReferenceChunkAllocator() noexcept { return chunkAllocator; }
+
+		/**
+		* Storage mode of archetypes which created after this call, already existing archetypes keep their storage mode.
+		* Destroy, Detach and Attach may move other entity of dense archetype, so it nullyfies pointers that acquired from Get.
+		*/
+		void SetChunkStorageMode(const ChunkStorageMode storageMode)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			chunkStorageMode = storageMode;
+		}
+
+		static void DestroyInstance()
+		{
+			std::call_once(instanceDestructionOnceFlag, []()
+				{
+					ComponentArchive* archive = nullptr;
+					{
+						std::lock_guard lock{ instanceLifetimeMutex };
+						archive = instance.release();
+					}
+
+					delete archive;
+				});
+		}
+
+		/**
+		* Handle comes from reservation of calling thread and its record is issued without lock, so threads never contend until their blocks run out.
+		* It recycles index of destroyed entity with next generation.
+		*/
+		Entity CreateEntity()
+		{
+			EntityReservation& reservation = LocalReservation();
+			if (reservation.Recycled.empty() && reservation.NextIndex == reservation.EndIndex)
+			{
+				RefillReservation(reservation);
+			}
+
+			Entity entity = INVALID_ENTITY_HANDLE;
+			if (!reservation.Recycled.empty())
+			{
+				entity = reservation.Recycled.back();
+				reservation.Recycled.pop_back();
+			}
+			else
+			{
+				entity = MakeEntity(static_cast<EntityIndex>(reservation.NextIndex++), FIRST_ENTITY_GENERATION);
+			}
+
+			IssueRecord(entity);
+			return entity;
+		}
+
+		/** Recycled handles are used first, rest of handles are reserved from global source at once. */
+		void CreateEntities(const std::span<Entity> entities)
+		{
+			EntityReservation& reservation = LocalReservation();
+			size_t numOfCreated = std::min(entities.size(), reservation.Recycled.size());
+			std::copy(reservation.Recycled.end() - numOfCreated, reservation.Recycled.end(), entities.begin());
+			reservation.Recycled.resize(reservation.Recycled.size() - numOfCreated);
+
+			const size_t numOfReserved = std::min<size_t>(entities.size() - numOfCreated, reservation.EndIndex - reservation.NextIndex);
+			for (size_t idx = 0; idx < numOfReserved; ++idx)
+			{
+				entities[numOfCreated++] = MakeEntity(static_cast<EntityIndex>(reservation.NextIndex++), FIRST_ENTITY_GENERATION);
+			}
+
+			if (numOfCreated < entities.size())
+			{
+				const uint64_t firstIndex = ReserveEntityIndices(entities.size() - numOfCreated);
+				for (uint64_t index = firstIndex; numOfCreated < entities.size(); ++index)
+				{
+					entities[numOfCreated++] = MakeEntity(static_cast<EntityIndex>(index), FIRST_ENTITY_GENERATION);
+				}
+			}
+
+			for (const Entity entity : entities)
+			{
+				IssueRecord(entity);
+			}
+		}
+
+		/** Number of handles in global pool, any thread reuses them when its reservation runs out. */
+		[[nodiscard]] size_t NumOfPooledEntities() const noexcept { return numOfPooledEntities.load(std::memory_order_relaxed); }
+
+		/** False if entity is destroyed or its handle is not issued yet, it only compares generation of handle with its record. */
+		[[nodiscard]] bool IsAlive(const Entity entity) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			return IsIssuedUnsafe(entity);
+		}
+
+		[[nodiscard]] bool Contains(const Entity entity, const ComponentID componentID) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ArchetypeData* archetypeData = FindRecordUnsafe(entity);
+			return archetypeData != nullptr && ReferenceSignature(archetypeData->ArchetypeIndex).Contains(componentID);
+		}
+
+		template <typename T>
+		[[nodiscard]] bool Contains(const Entity entity) const
+		{
+			return Contains(entity, QueryComponentID<T>());
+		}
+
+		[[nodiscard]] bool IsSameArchetype(const Entity lhs, const Entity rhs) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ArchetypeData* lhsArchetypeData = FindRecordUnsafe(lhs);
+			const ArchetypeData* rhsArchetypeData = FindRecordUnsafe(rhs);
+			if (lhsArchetypeData != nullptr && rhsArchetypeData != nullptr)
+			{
+				return lhsArchetypeData->ArchetypeIndex == rhsArchetypeData->ArchetypeIndex;
+			}
+
+			// If both entities are not alive, it means those are empty and at same time equal archetype.
+			return lhsArchetypeData == rhsArchetypeData;
+		}
+
+		[[nodiscard]] Archetype QueryArchetype(const Entity entity) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			if (const ArchetypeData* archetypeData = FindRecordUnsafe(entity); archetypeData != nullptr)
+			{
+				return ReferenceSignature(archetypeData->ArchetypeIndex).ToArchetype();
+			}
+
+			return Archetype();
+		}
+
+		/** Archetype of entity except disabled components. */
+		[[nodiscard]] Archetype QueryEnabledArchetype(const Entity entity) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			if (const ArchetypeData* foundArchetypeData = FindRecordUnsafe(entity); foundArchetypeData != nullptr)
+			{
+				const ArchetypeData& archetypeData = *foundArchetypeData;
+				Archetype archetype = ReferenceSignature(archetypeData.ArchetypeIndex).ToArchetype();
+				const ChunkList& chunkList = chunkListLUT.at(archetypeData.ArchetypeIndex).second;
+				for (const ComponentID componentID : chunkList.EnableableComponents())
+				{
+					if (!chunkList.IsEnabled(archetypeData.Allocation(), componentID))
+					{
+						archetype.erase(componentID);
+					}
+				}
+
+				return archetype;
+			}
+
+			return Archetype();
+		}
+
+		/**
+		* Enable or disable enableable component without moving entity to other archetype. It stamps component column with current version.
+		* Disabled component still holds its data, but queries and filters treat entity as it does not have component.
+		* @return	False if entity does not have component or component is not enableable.
+		*/
+		bool SetEnabled(const Entity entity, const ComponentID componentID, const bool bEnabled)
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			if (ContainsUnsafe(entity, componentID))
+			{
+				const auto& archetypeData = *FindRecordUnsafe(entity);
+				ChunkList& chunkList = ReferenceChunkList(archetypeData.ArchetypeIndex);
+				if (chunkList.IsEnableable(componentID) && chunkList.SetEnabled(archetypeData.Allocation(), componentID, bEnabled))
+				{
+					chunkList.MarkChanged(archetypeData.Allocation().ChunkIndex, componentID, CurrentVersion());
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		template <ComponentType T>
+		bool Enable(const Entity entity)
+		{
+			static_assert(IS_ENABLEABLE_COMPONENT<T>, "Component must be declared by DeclareEnableableComponent.");
+			return SetEnabled(entity, QueryComponentID<T>(), true);
+		}
+
+		template <ComponentType T>
+		bool Disable(const Entity entity)
+		{
+			static_assert(IS_ENABLEABLE_COMPONENT<T>, "Component must be declared by DeclareEnableableComponent.");
+			return SetEnabled(entity, QueryComponentID<T>(), false);
+		}
+
+		/** Return false if entity does not have component. Component which is not enableable is always enabled. */
+		[[nodiscard]] bool IsEnabled(const Entity entity, const ComponentID componentID) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			if (ContainsUnsafe(entity, componentID))
+			{
+				const auto& archetypeData = *FindRecordUnsafe(entity);
+				const ChunkList& chunkList = chunkListLUT.at(archetypeData.ArchetypeIndex).second;
+				return !chunkList.IsEnableable(componentID) || chunkList.IsEnabled(archetypeData.Allocation(), componentID);
+			}
+
+			return false;
+		}
+
+		template <ComponentType T>
+		[[nodiscard]] bool IsEnabled(const Entity entity) const
+		{
+			return IsEnabled(entity, QueryComponentID<T>());
+		}
+
+		/** Return nullptr, if component is already exist or failed to attach. Shared component must be attached through SetShared. */
+		bool Attach(const Entity entity, const ComponentID componentID, const bool bCallDefaultConstructor = true)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			if (ComponentRegistry::DataOf(componentID).Info.bIsShared)
+			{
+				assert(false && "Shared component must be attached through SetShared.");
+				return false;
+			}
+
+			void* result = nullptr;
+			/** Destroyed entity can not get component again. */
+			if (ArchetypeData* foundArchetypeData = AcquireRecordUnsafe(entity); foundArchetypeData != nullptr && !ContainsUnsafe(entity, componentID))
+			{
+				ArchetypeData& archetypeData = *foundArchetypeData;
+				const ArchetypeEdge& edge = FindOrCreateEdge(archetypeData.ArchetypeIndex, componentID, true);
+				const auto newChunkListIdx = edge.TargetChunkListIndex;
+				MoveAllocation(entity, archetypeData, newChunkListIdx, &edge.Plan);
+				const ChunkList::Allocation newAllocation = archetypeData.Allocation();
+
+				const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+				if (dynamicComponentData.Info.bIsTag)
+				{
+					return true;
+				}
+
+				if (!dynamicComponentData.Info.Fields.empty())
+				{
+					/** Declared fields are trivially copyable, so copying fields of default object is same as constructing new one. */
+					if (bCallDefaultConstructor)
+					{
+						ReferenceChunkList(newChunkListIdx).ScatterFields(newAllocation, componentID, dynamicComponentData.DefaultFieldSource);
+					}
+
+					return true;
+				}
+
+				result = ReferenceChunkList(newChunkListIdx).AddressOf(newAllocation, componentID);
+				if (result != nullptr && bCallDefaultConstructor)
+				{
+					dynamicComponentData.Construct(result);
+				}
+			}
+
+			return result != nullptr;
+		}
+
+		template <ComponentType T, typename... Args>
+		bool Attach(const Entity entity, Args&&... args)
+		{
+			static_assert(!IS_SHARED_COMPONENT<T>, "Shared component must be attached through SetShared.");
+			constexpr bool bShouldCallDefaultConstructor = (sizeof...(Args) == 0);
+			const ComponentID componentID = QueryComponentID<T>();
+			void* result = nullptr;
+
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			/** Destroyed entity can not get component again. */
+			if (ArchetypeData* foundArchetypeData = AcquireRecordUnsafe(entity); foundArchetypeData != nullptr && !ContainsUnsafe(entity, componentID))
+			{
+				ArchetypeData& archetypeData = *foundArchetypeData;
+				const ArchetypeEdge& edge = FindOrCreateEdge(archetypeData.ArchetypeIndex, componentID, true);
+				const auto newChunkListIdx = edge.TargetChunkListIndex;
+				MoveAllocation(entity, archetypeData, newChunkListIdx, &edge.Plan);
+				const ChunkList::Allocation newAllocation = archetypeData.Allocation();
+
+				if constexpr (IS_TAG_COMPONENT<T>)
+				{
+					return true;
+				}
+				else if constexpr (FieldSplitComponentType<T>)
+				{
+					/** Object only lives during attach, its declared fields are scattered into sub-columns. */
+					const T component(std::forward<Args>(args)...);
+					ReferenceChunkList(newChunkListIdx).ScatterFields(newAllocation, componentID, &component);
+					return true;
+				}
+				else
+				{
+					result = ReferenceChunkList(newChunkListIdx).AddressOf(newAllocation, componentID);
+					if (result != nullptr)
+					{
+						if (bShouldCallDefaultConstructor)
+						{
+							const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+							dynamicComponentData.Construct(result);
+						}
+						else
+						{
+							new (result) T(std::forward<Args>(args)...);
+						}
+					}
+				}
+			}
+
+			return result != nullptr;
+		}
+
+		/**
+		* Attach several components through single archetype migration, entity never passes through archetypes which have only part of them.
+		* Nothing is attached and return false if entity already has any of given components.
+		*/
+		bool Attach(const Entity entity, const std::span<const ComponentID> componentIDs, const bool bCallDefaultConstructor = true)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			const std::optional<size_t> newChunkListIdx = MoveToAttachedArchetypeUnsafe(entity, componentIDs);
+			if (!newChunkListIdx.has_value())
+			{
+				return false;
+			}
+
+			if (bCallDefaultConstructor)
+			{
+				const ChunkList::Allocation newAllocation = FindRecordUnsafe(entity)->Allocation();
+				for (const ComponentID componentID : componentIDs)
+				{
+					ConstructDefaultUnsafe(*newChunkListIdx, newAllocation, componentID);
+				}
+			}
+
+			return true;
+		}
+
+		template <ComponentType... Ts>
+			requires (sizeof...(Ts) > 1)
+		bool Attach(const Entity entity)
+		{
+			static_assert(!(IS_SHARED_COMPONENT<Ts> || ...), "Shared component must be attached through SetShared.");
+			const std::array<ComponentID, sizeof...(Ts)> componentIDs = { QueryComponentID<Ts>()... };
+			return Attach(entity, componentIDs);
+		}
+
+		/** Each component is move constructed from given object in place. */
+		template <ComponentType... Ts>
+			requires (sizeof...(Ts) > 1)
+		bool Attach(const Entity entity, Ts... components)
+		{
+			static_assert(!(IS_SHARED_COMPONENT<Ts> || ...), "Shared component must be attached through SetShared.");
+			const std::array<ComponentID, sizeof...(Ts)> componentIDs = { QueryComponentID<Ts>()... };
+
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			const std::optional<size_t> newChunkListIdx = MoveToAttachedArchetypeUnsafe(entity, componentIDs);
+			if (!newChunkListIdx.has_value())
+			{
+				return false;
+			}
+
+			const ChunkList::Allocation newAllocation = FindRecordUnsafe(entity)->Allocation();
+			(ConstructUnsafe<Ts>(*newChunkListIdx, newAllocation, std::move(components)), ...);
+			return true;
+		}
+
+		/**
+		* Spawn entities directly into archetype of given components, entity handles are generated as block and rows are created chunk by chunk.
+		* Components are default constructed column by column, then initializer is called per entity with reference of each components.
+		* Field split component does not live in chunk, so it must be attached through Attach.
+		* @param	initializer		Called as initializer(index of entity, Ts&... components).
+		* @return	Spawned entities, in order of index which passed to initializer.
+		*/
+		template <ComponentType... Ts, typename Initializer>
+		std::vector<Entity> Spawn(const size_t count, Initializer&& initializer)
+		{
+			static_assert(sizeof...(Ts) > 0, "Spawned entity must have at least one component.");
+			static_assert(!(IS_SHARED_COMPONENT<Ts> || ...), "Shared component must be attached through SetShared.");
+			static_assert(!(FieldSplitComponentType<Ts> || ...), "Field split component must be attached through Attach.");
+			std::vector<Entity> entities(count);
+			ArchetypeSignature signature;
+			((signature = signature.With(QueryComponentID<Ts>())), ...);
+			assert(signature.Size() == sizeof...(Ts) && "Component types of spawn must be unique.");
+
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			CreateEntities(entities);
+			for (const Entity entity : entities)
+			{
+				[[maybe_unused]] const ArchetypeData* record = AcquireRecordUnsafe(entity);
+				assert(record != nullptr && "Freshly created entity must get its record.");
+			}
+
+			const size_t chunkListIdx = FindOrCreateChunkList(std::move(signature));
+			ChunkList& chunkList = ReferenceChunkList(chunkListIdx);
+			if (!chunkList.HasStorage())
+			{
+				/** Tag only archetype has no row to create. */
+				for (size_t entityIndex = 0; entityIndex < count; ++entityIndex)
+				{
+					EnterChunkListWithoutStorageUnsafe(chunkListIdx, entities[entityIndex], RecordOf(entities[entityIndex]).Data);
+					std::invoke(initializer, entityIndex, *SpawnColumnOf<Ts>(chunkList, ChunkList::Allocation())...);
+				}
+
+				return entities;
+			}
+
+			const uint64_t version = CurrentVersion();
+			size_t entityIndex = 0;
+			chunkList.CreateBulk(entities, [&](const ChunkList::Allocation first, const size_t numOfRows)
+				{
+					chunkList.MarkChanged(first.ChunkIndex, version);
+					for (size_t row = 0; row < numOfRows; ++row)
+					{
+						RecordOf(entities[entityIndex + row]).Data = ArchetypeData::Pack(
+							chunkListIdx,
+							ChunkList::Allocation{ .ChunkIndex = first.ChunkIndex, .AllocationIndexOfEntity = first.AllocationIndexOfEntity + row });
+					}
+
+					const std::tuple<Ts*...> columns = { SpawnColumnOf<Ts>(chunkList, first)... };
+					/** Same range lifecycle as destruction of column, so rows are value constructed as single range per column. */
+					([&columns, numOfRows]()
+						{
+							if constexpr (!IS_TAG_COMPONENT<Ts>)
+							{
+								ComponentLifecycle<Ts>::ConstructRange(std::get<Ts*>(columns), numOfRows);
+							}
+						}(), ...);
+
+					for (size_t row = 0; row < numOfRows; ++row)
+					{
+						std::invoke(initializer, entityIndex + row, *(std::get<Ts*>(columns) + (IS_TAG_COMPONENT<Ts> ? 0 : row))...);
+					}
+
+					entityIndex += numOfRows;
+				});
+
+			return entities;
+		}
+
+		template <ComponentType... Ts>
+		std::vector<Entity> Spawn(const size_t count)
+		{
+			return Spawn<Ts...>(count, [](const size_t, const Ts&...) {});
+		}
+
+		void Detach(const Entity entity, const ComponentID componentID)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			if (ContainsUnsafe(entity, componentID))
+			{
+				ArchetypeData& archetypeData = *FindRecordUnsafe(entity);
+
+				const auto oldChunkListIdx = archetypeData.ArchetypeIndex;
+				const ChunkList::Allocation oldAllocation = archetypeData.Allocation();
+				/** Shared value is destroyed when last entity which shares it released it. */
+				const void* detachSharedValue = ReferenceChunkList(oldChunkListIdx).SharedValueOf(componentID);
+				/** Field split and tag component have no object to destroy. */
+				void* detachComponentPtr = oldAllocation.IsFailedToAllocate() ? nullptr : ReferenceChunkList(oldChunkListIdx).AddressOf(oldAllocation, componentID);
+				if (detachSharedValue == nullptr && detachComponentPtr != nullptr)
+				{
+					const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+					dynamicComponentData.Destroy(detachComponentPtr);
+				}
+
+				/** Empty archetype falls back to null archetype, which has no storage. */
+				const ArchetypeEdge& edge = FindOrCreateEdge(oldChunkListIdx, componentID, false);
+				MoveAllocation(entity, archetypeData, edge.TargetChunkListIndex, &edge.Plan);
+
+				if (detachSharedValue != nullptr)
+				{
+					ReleaseSharedValue(componentID, detachSharedValue);
+				}
+			}
+		}
+
+		template <ComponentType T>
+		void Detach(const Entity entity)
+		{
+			Detach(entity, QueryComponentID<T>());
+		}
+
+		/**
+		* @brief	Return Deferred Access Handle Object.
+		*/
+		template <ComponentType T>
+		[[nodiscard]] ComponentHandle<T> GetHandle(const Entity entity) noexcept
+		{
+			return ComponentHandle<T>(*this, entity);
+		}
+
+		/**
+		* Read-only access, it does not change version of component.
+		* Column lookup of chunk list answers whether entity has component, so it costs one entity lookup and one column lookup.
+		*/
+		[[nodiscard]] const void* Get(const Entity entity, const ComponentID componentID) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ArchetypeData* archetypeData = FindRecordUnsafe(entity);
+			if (archetypeData != nullptr && archetypeData->Row != ArchetypeData::INVALID_ROW)
+			{
+				return chunkListLUT[archetypeData->ArchetypeIndex].second.AddressOf(archetypeData->Allocation(), componentID);
+			}
+
+			return nullptr;
+		}
+
+		/** Writable access, it stamps component column of owner chunk with current version. Use Get to only read it. */
+		[[nodiscard]] void* GetMut(const Entity entity, const ComponentID componentID)
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ArchetypeData* archetypeData = FindRecordUnsafe(entity);
+			if (archetypeData != nullptr && archetypeData->Row != ArchetypeData::INVALID_ROW)
+			{
+				return chunkListLUT[archetypeData->ArchetypeIndex].second.AddressOf(archetypeData->Allocation(), componentID, CurrentVersion());
+			}
+
+			return nullptr;
+		}
+
+		template <ComponentType T>
+		[[nodiscard]] const T* Get(const Entity entity) const
+		{
+			static_assert(!FieldSplitComponentType<T>, "Field split component does not live in chunk, use GetField instead.");
+			static_assert(!IS_TAG_COMPONENT<T>, "Tag component has no data, use Contains instead.");
+			return static_cast<const T*>(Get(entity, QueryComponentID<T>()));
+		}
+
+		template <ComponentType T>
+		[[nodiscard]] T* GetMut(const Entity entity)
+		{
+			static_assert(!FieldSplitComponentType<T>, "Field split component does not live in chunk, use GetFieldMut instead.");
+			static_assert(!IS_TAG_COMPONENT<T>, "Tag component has no data, use Contains instead.");
+			return static_cast<T*>(GetMut(entity, QueryComponentID<T>()));
+		}
+
+		/** Read-only access to declared field of field split component. */
+		template <auto Member>
+		[[nodiscard]] const FieldTypeOf<Member>* GetField(const Entity entity) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ComponentID componentID = QueryComponentID<FieldOwnerOf<Member>>();
+			if (ContainsUnsafe(entity, componentID))
+			{
+				const auto& archetypeData = *FindRecordUnsafe(entity);
+				return static_cast<const FieldTypeOf<Member>*>(chunkListLUT.at(archetypeData.ArchetypeIndex).second.FieldAddressOf(archetypeData.Allocation(), componentID, FieldIndexOf<Member>()));
+			}
+
+			return nullptr;
+		}
+
+		/** Writable access to declared field of field split component, it stamps component with current version. */
+		template <auto Member>
+		[[nodiscard]] FieldTypeOf<Member>* GetFieldMut(const Entity entity)
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ComponentID componentID = QueryComponentID<FieldOwnerOf<Member>>();
+			if (ContainsUnsafe(entity, componentID))
+			{
+				const auto& archetypeData = *FindRecordUnsafe(entity);
+				ChunkList& chunkList = ReferenceChunkList(archetypeData.ArchetypeIndex);
+				chunkList.MarkChanged(archetypeData.Allocation().ChunkIndex, componentID, CurrentVersion());
+				return static_cast<FieldTypeOf<Member>*>(chunkList.FieldAddressOf(archetypeData.Allocation(), componentID, FieldIndexOf<Member>()));
+			}
+
+			return nullptr;
+		}
+
+		/** Version which writes are stamped with at now. */
+		[[nodiscard]] uint64_t CurrentVersion() const noexcept
+		{
+			return globalVersion.load(std::memory_order_relaxed);
+		}
+
+		/**
+		* Close current version and return it. Every writes after this call are stamped with greater version,
+		* so system can pass returned version to ForEachChunk at next update to visit only changed chunks.
+		*/
+		uint64_t AdvanceVersion() noexcept
+		{
+			return globalVersion.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/**
+		* Call function(ChunkView&) for every non-empty chunks of archetypes which contain all of filter components.
+		* If changedSinceVersion is not 0, chunks which none of filter components(or any components if filter is empty) written after that version are skipped.
+		* Chunks which have no row with every enableable filter components enabled are skipped, ChunkView::IsEnabled tells state of each rows.
+		* Function must not change structure of archive(Attach, Detach, Destroy, Defragmentation...).
+		*/
+		template <typename Function>
+		void ForEachChunk(const Archetype& filter, Function&& function, const uint64_t changedSinceVersion = 0)
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			ForEachChunkUnsafe(filter, [](const ChunkList&) { return true; }, std::forward<Function>(function), changedSinceVersion);
+		}
+
+		template <ComponentType... Ts, typename Function>
+		void ForEachChunk(Function&& function, const uint64_t changedSinceVersion = 0)
+		{
+			const Archetype filterArchetype = { QueryComponentID<Ts>()... };
+			ForEachChunk(filterArchetype, std::forward<Function>(function), changedSinceVersion);
+		}
+
+		/** Same as ForEachChunk, but only visits chunks which every rows share value equal to given value. */
+		template <SharedComponentType T, typename Function>
+		void ForEachChunkSharing(const T& value, const Archetype& filter, Function&& function, const uint64_t changedSinceVersion = 0)
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			const ComponentID componentID = QueryComponentID<T>();
+			const void* sharedValue = FindSharedValue(componentID, &value);
+			if (sharedValue != nullptr)
+			{
+				Archetype sharingFilter = filter;
+				sharingFilter.insert(componentID);
+				ForEachChunkUnsafe(sharingFilter, [componentID, sharedValue](const ChunkList& chunkList) { return chunkList.SharedValueOf(componentID) == sharedValue; }, std::forward<Function>(function), changedSinceVersion);
+			}
+		}
+
+		template <SharedComponentType T, ComponentType... Ts, typename Function>
+		void ForEachChunkSharing(const T& value, Function&& function, const uint64_t changedSinceVersion = 0)
+		{
+			const Archetype filterArchetype = { QueryComponentID<Ts>()... };
+			ForEachChunkSharing(value, filterArchetype, std::forward<Function>(function), changedSinceVersion);
+		}
+
+		/**
+		* Attach shared component or change its value. Entity moves to chunk list of entities which share equal value,
+		* so it nullyfies pointers that acquired from Get.
+		*/
+		template <SharedComponentType T>
+		void SetShared(const Entity entity, const T& value)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock{ mutex };
+#endif
+			const ComponentID componentID = QueryComponentID<T>();
+			ArchetypeData* foundArchetypeData = AcquireRecordUnsafe(entity);
+			if (foundArchetypeData == nullptr)
+			{
+				return;
+			}
+
+			ArchetypeData& archetypeData = *foundArchetypeData;
+			const size_t oldChunkListIdx = archetypeData.ArchetypeIndex;
+			const void* oldSharedValue = ReferenceChunkList(oldChunkListIdx).SharedValueOf(componentID);
+			const void* newSharedValue = AcquireSharedValue(componentID, &value);
+			if (oldSharedValue == newSharedValue)
+			{
+				ReleaseSharedValue(componentID, newSharedValue);
+				return;
+			}
+
+			ArchetypeSignature signature = ReferenceSignature(oldChunkListIdx).With(componentID);
+			std::vector<const void*> sharedValues = CollectSharedValues(signature, oldChunkListIdx, componentID, newSharedValue);
+			MoveAllocation(entity, archetypeData, FindOrCreateChunkList(std::move(signature), std::move(sharedValues)));
+			if (oldSharedValue != nullptr)
+			{
+				ReleaseSharedValue(componentID, oldSharedValue);
+			}
+		}
+
+		/** Return nullptr if entity does not have shared component. */
+		template <SharedComponentType T>
+		[[nodiscard]] const T* GetShared(const Entity entity) const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			if (const ArchetypeData* archetypeData = FindRecordUnsafe(entity); archetypeData != nullptr)
+			{
+				return static_cast<const T*>(chunkListLUT.at(archetypeData->ArchetypeIndex).second.SharedValueOf(QueryComponentID<T>()));
+			}
+
+			return nullptr;
+		}
+
+		/** Number of distinct values of shared component which are shared by at least one entity. */
+		template <SharedComponentType T>
+		[[nodiscard]] size_t NumOfSharedValues() const
+		{
+#if SY_ECS_THREAD_SAFE
+			ReadOnlyLock_t lock{ mutex };
+#endif
+			return sharedValueLUT[QueryComponentID<T>()].size();
+		}
+
+		void Destroy(const Entity entity)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			/** Entity which never had any component is also released, so its generation is increased. */
+			if (const ArchetypeData* foundArchetypeData = AcquireRecordUnsafe(entity); foundArchetypeData != nullptr)
+			{
+				const ArchetypeData& archetypeData = *foundArchetypeData;
+				const ArchetypeSignature& archetype = ReferenceSignature(archetypeData.ArchetypeIndex);
+				const auto chunkList = archetypeData.ArchetypeIndex;
+				const ChunkList::Allocation oldAllocation = archetypeData.Allocation();
+				/** Entity which only has tag components has no allocation. */
+				const bool bHasAllocation = !oldAllocation.IsFailedToAllocate();
+				for (const ComponentID componentID : archetype)
+				{
+					if (const void* sharedValue = ReferenceChunkList(chunkList).SharedValueOf(componentID); sharedValue != nullptr)
+					{
+						ReleaseSharedValue(componentID, sharedValue);
+					}
+					else if (void* detachComponentPtr = bHasAllocation ? ReferenceChunkList(chunkList).AddressOf(oldAllocation, componentID) : nullptr; detachComponentPtr != nullptr)
+					{
+						const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+						dynamicComponentData.Destroy(detachComponentPtr);
+					}
+				}
+
+				if (bHasAllocation)
+				{
+					const Entity movedEntity = ReferenceChunkList(chunkList).Destroy(oldAllocation);
+					UpdateMovedAllocation(movedEntity, oldAllocation);
+				}
+				else
+				{
+					LeaveChunkListWithoutStorageUnsafe(archetypeData);
+				}
+
+				RecycleEntity(ReleaseRecordUnsafe(entity));
+			}
+		}
+
+		/**
+		* Destroy every entities which have every components of filter, whole chunk list at a time.
+		* Entity which has no component belongs to null archetype, it is never matched even by empty filter.
+		* Destructors run column by column and chunks are returned to chunk allocator at once, without moving any row.
+		* @return	Number of destroyed entities.
+		*/
+		size_t DestroyAll(const Archetype& filter)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			size_t numOfDestroyedEntities = 0;
+			for (size_t idx = 1; idx < chunkListLUT.size(); ++idx) // Except null archetype
+			{
+				if (!ReferenceSignature(idx).Includes(filter))
+				{
+					continue;
+				}
+
+				const std::vector<Entity> entities = EntitiesOfChunkListUnsafe(idx);
+				if (entities.empty())
+				{
+					continue;
+				}
+
+				ChunkList& chunkList = ReferenceChunkList(idx);
+				for (const ComponentID componentID : ReferenceSignature(idx))
+				{
+					if (const void* sharedValue = chunkList.SharedValueOf(componentID); sharedValue != nullptr)
+					{
+						ReleaseSharedValue(componentID, sharedValue, entities.size());
+					}
+					else
+					{
+						DestroyColumnUnsafe(chunkList, componentID);
+					}
+				}
+
+				/** Handles go straight to global pool, so they are not stuck in calling thread which may be short lived. */
+				std::vector<Entity> recycledEntities;
+				recycledEntities.reserve(entities.size());
+				for (const Entity entity : entities)
+				{
+					recycledEntities.emplace_back(ReleaseRecordUnsafe(entity));
+				}
+
+				PoolEntities(recycledEntities);
+				chunkList.Clear();
+				numOfDestroyedEntities += entities.size();
+			}
+
+			return numOfDestroyedEntities;
+		}
+
+		template <ComponentType... Ts>
+		size_t DestroyAll()
+		{
+			return DestroyAll(Archetype{ QueryComponentID<Ts>()... });
+		}
+
+		/**
+		* Attach component to every entities which have every components of filter, each archetype moves into its target archetype whole chunk at a time.
+		* Columns of consecutive rows are copied as single block instead of moving entities one by one.
+		* Entity which has no component belongs to null archetype, it is never matched even by empty filter.
+		* @return	Number of entities which got component.
+		*/
+		size_t AttachAll(const Archetype& filter, const ComponentID componentID, const bool bCallDefaultConstructor = true)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			if (ComponentRegistry::DataOf(componentID).Info.bIsShared)
+			{
+				assert(false && "Shared component must be attached through SetShared.");
+				return 0;
+			}
+
+			size_t numOfAttachedEntities = 0;
+			/** Target chunk lists are created during iteration, but they already have component. */
+			const size_t numOfChunkLists = chunkListLUT.size();
+			for (size_t idx = 1; idx < numOfChunkLists; ++idx) // Except null archetype
+			{
+				const ArchetypeSignature& signature = ReferenceSignature(idx);
+				if (signature.Contains(componentID) || !signature.Includes(filter) || ReferenceChunkList(idx).NumOfEntities() == 0)
+				{
+					continue;
+				}
+
+				const size_t destChunkListIdx = FindOrCreateEdge(idx, componentID, true).TargetChunkListIndex;
+				numOfAttachedEntities += MoveChunkListUnsafe(idx, destChunkListIdx, [this, destChunkListIdx, componentID, bCallDefaultConstructor](const ChunkList::Allocation first, const size_t numOfRows)
+					{
+						if (bCallDefaultConstructor)
+						{
+							ConstructDefaultUnsafe(destChunkListIdx, first, componentID, numOfRows);
+						}
+					});
+			}
+
+			return numOfAttachedEntities;
+		}
+
+		template <ComponentType T>
+		size_t AttachAll(const Archetype& filter = {})
+		{
+			static_assert(!IS_SHARED_COMPONENT<T>, "Shared component must be attached through SetShared.");
+			return AttachAll(filter, QueryComponentID<T>());
+		}
+
+		/**
+		* Detach component from every entities which have it and every components of filter, each archetype moves into its target archetype whole chunk at a time.
+		* @return	Number of entities which lost component.
+		*/
+		size_t DetachAll(const Archetype& filter, const ComponentID componentID)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			size_t numOfDetachedEntities = 0;
+			const size_t numOfChunkLists = chunkListLUT.size();
+			for (size_t idx = 1; idx < numOfChunkLists; ++idx) // Except null archetype
+			{
+				const ArchetypeSignature& signature = ReferenceSignature(idx);
+				if (!signature.Contains(componentID) || !signature.Includes(filter) || ReferenceChunkList(idx).NumOfEntities() == 0)
+				{
+					continue;
+				}
+
+				/** Shared value is released after entities left chunk list which refers it. */
+				const void* detachSharedValue = ReferenceChunkList(idx).SharedValueOf(componentID);
+				if (detachSharedValue == nullptr)
+				{
+					DestroyColumnUnsafe(ReferenceChunkList(idx), componentID);
+				}
+
+				const size_t destChunkListIdx = FindOrCreateEdge(idx, componentID, false).TargetChunkListIndex;
+				const size_t numOfMovedEntities = MoveChunkListUnsafe(idx, destChunkListIdx, [](const ChunkList::Allocation, const size_t) {});
+				if (detachSharedValue != nullptr && numOfMovedEntities > 0)
+				{
+					ReleaseSharedValue(componentID, detachSharedValue, numOfMovedEntities);
+				}
+
+				numOfDetachedEntities += numOfMovedEntities;
+			}
+
+			return numOfDetachedEntities;
+		}
+
+		template <ComponentType T>
+		size_t DetachAll(const Archetype& filter = {})
+		{
+			return DetachAll(filter, QueryComponentID<T>());
+		}
+
+		/**
+		* Trying to de-fragment 'entire' chunk lists, by moving rows from tail chunks into free slots of head chunks.
+		* Chunk lists are independent, so they are compacted by given number of workers in parallel(calling thread is one of workers).
+		* It maybe will nullyfies any references, pointers that acquired from Attach and Get methods.
+		*/
+		void Defragmentation(const size_t numOfWorkers = 1)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			DefragmentationUnsafe(numOfWorkers);
+		}
+
+		/**
+		* Incremental defragmentation which stops when given time budget is exhausted, next call resumes from archetype where it stopped.
+		* The most fragmented archetype(lowest fill ratio) is compacted first, by moving rows from its last chunk into lower free slots.
+		* Emptied trailing chunks are returned to chunk allocator without changing index of other chunks.
+		* It maybe will nullyfies any references, pointers that acquired from Attach and Get methods.
+		*/
+		DefragmentationStepResult DefragmentStep(const std::chrono::microseconds budget)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			/** Reading clock costs more than moving a row, so check budget once per few moves. */
+			constexpr size_t NUM_OF_MOVES_PER_BUDGET_CHECK = 64;
+			const auto deadline = std::chrono::steady_clock::now() + budget;
+			DefragmentationStepResult result;
+			size_t numOfMovesSinceBudgetCheck = 0;
+			while (true)
+			{
+				if (defragmentingChunkListIdx >= chunkListLUT.size())
+				{
+					defragmentingChunkListIdx = FindMostFragmentedChunkList();
+					if (defragmentingChunkListIdx >= chunkListLUT.size())
+					{
+						result.bIsCompleted = true;
+						break;
+					}
+				}
+
+				ChunkList& chunkList = ReferenceChunkList(defragmentingChunkListIdx);
+				const size_t lastChunkIndex = chunkList.LastNonEmptyChunkIndex();
+				if (lastChunkIndex < chunkList.NumOfChunks() && chunkList.FreeChunkIndex() < lastChunkIndex)
+				{
+					/** Last row of chunk is always occupied, in both of storage modes. */
+					const Entity entity = chunkList.EntitiesOf(lastChunkIndex).back();
+					ArchetypeData& archetypeData = *FindRecordUnsafe(entity);
+					const ChunkList::Allocation oldAllocation = archetypeData.Allocation();
+					const ChunkList::Allocation newAllocation = CreateAllocation(defragmentingChunkListIdx, entity);
+					const Entity movedEntity = ChunkList::MoveData(
+						chunkList, oldAllocation,
+						chunkList, newAllocation);
+
+					archetypeData.SetAllocation(newAllocation);
+					UpdateMovedAllocation(movedEntity, oldAllocation);
+					++result.NumOfMovedEntities;
+					if (++numOfMovesSinceBudgetCheck < NUM_OF_MOVES_PER_BUDGET_CHECK)
+					{
+						continue;
+					}
+
+					numOfMovesSinceBudgetCheck = 0;
+				}
+				else
+				{
+					const size_t numOfFreedChunks = chunkList.ReleaseTrailingEmptyChunks();
+					result.NumOfFreedChunks += numOfFreedChunks;
+					result.FreedBytes += numOfFreedChunks * chunkList.ChunkSize();
+					defragmentingChunkListIdx = std::numeric_limits<size_t>::max();
+				}
+
+				if (std::chrono::steady_clock::now() >= deadline)
+				{
+					break;
+				}
+			}
+
+			return result;
+		}
+
+		/**
+		* Empty chunks are recycled through chunk allocator, only memory over its retention limit returns to OS.
+		* Chunk lists are defragmented and shrunk by given number of workers in parallel.
+		*/
+		size_t ShrinkToFit(const bool bPerformShrinkAfterDefrag = true, const size_t numOfWorkers = 1)
+		{
+#if SY_ECS_THREAD_SAFE
+			WriteLock_t lock(mutex);
+#endif
+			if (bPerformShrinkAfterDefrag)
+			{
+				DefragmentationUnsafe(numOfWorkers);
+			}
+
+			chunkListLUT.shrink_to_fit();
+
+			std::atomic<size_t> reduced = 0;
+			ForEachChunkListParallel(numOfWorkers, [&reduced](ChunkList& chunkList)
+				{
+					reduced.fetch_add(chunkList.ShrinkToFit(), std::memory_order_relaxed);
+				});
+
+			chunkAllocator.Trim();
+			return reduced.load(std::memory_order_relaxed);
+		}
+
+	private:
+		ComponentArchive() noexcept(false)
+		{
+			FindOrCreateChunkList(ArchetypeSignature());
+		}
+
+		/** Archetype which has shared components has chunk list per combination of shared values. */
+		size_t FindOrCreateChunkList(ArchetypeSignature signature, std::vector<const void*> sharedValues = {})
+		{
+			ChunkListKey key{ .Signature = std::move(signature), .SharedValues = std::move(sharedValues) };
+			const auto foundItr = chunkListIndexLUT.find(key);
+			if (foundItr != chunkListIndexLUT.end())
+			{
+				return foundItr->second;
+			}
+
+			const size_t idx = chunkListLUT.size();
+			chunkListLUT.emplace_back(key.Signature, ChunkList(chunkAllocator, RetrieveComponentInfosFromArchetype(key.Signature), chunkStorageMode, 0, key.SharedValues));
+			edgeLUT.emplace_back();
+			chunkListIndexLUT.emplace(std::move(key), idx);
+			return idx;
+		}
+
+		/**
+		* Follow cached edge of chunk list, edge is created at first transition.
+		* Returned reference is valid until next edge or chunk list is created.
+		*/
+		const ArchetypeEdge& FindOrCreateEdge(const size_t chunkListIdx, const ComponentID componentID, const bool bIsAttach)
+		{
+			{
+				const auto& edges = bIsAttach ? edgeLUT[chunkListIdx].Attach : edgeLUT[chunkListIdx].Detach;
+				const auto foundItr = edges.find(componentID);
+				if (foundItr != edges.end())
+				{
+					return foundItr->second;
+				}
+			}
+
+			const ArchetypeSignature& signature = ReferenceSignature(chunkListIdx);
+			ArchetypeSignature targetSignature = bIsAttach ? signature.With(componentID) : signature.Without(componentID);
+			std::vector<const void*> sharedValues = CollectSharedValues(targetSignature, chunkListIdx);
+			const size_t targetChunkListIdx = FindOrCreateChunkList(std::move(targetSignature), std::move(sharedValues));
+
+			/** Creating chunk list may reallocate edge LUT. */
+			auto& edges = bIsAttach ? edgeLUT[chunkListIdx].Attach : edgeLUT[chunkListIdx].Detach;
+			return edges.emplace(componentID, ArchetypeEdge{
+				.TargetChunkListIndex = targetChunkListIdx,
+				.Plan = ChunkList::BuildTransferPlan(ReferenceChunkList(chunkListIdx), ReferenceChunkList(targetChunkListIdx)) }).first->second;
+		}
+
+		/** Returned reference is valid until next plan or chunk list is created. */
+		const ChunkList::TransferPlan& FindOrCreateTransferPlan(const size_t srcChunkListIdx, const size_t destChunkListIdx)
+		{
+			auto& plans = edgeLUT[srcChunkListIdx].Jump;
+			const auto foundItr = plans.find(destChunkListIdx);
+			if (foundItr != plans.end())
+			{
+				return foundItr->second;
+			}
+
+			return plans.emplace(destChunkListIdx, ChunkList::BuildTransferPlan(ReferenceChunkList(srcChunkListIdx), ReferenceChunkList(destChunkListIdx))).first->second;
+		}
+
+		/**
+		* Move entity into archetype which also has every given components through single migration, attached components are not constructed.
+		* @return	Index of new chunk list of entity, nullopt if entity already has any of given components or any of them is shared component.
+		*/
+		std::optional<size_t> MoveToAttachedArchetypeUnsafe(const Entity entity, const std::span<const ComponentID> componentIDs)
+		{
+			ArchetypeData* foundArchetypeData = AcquireRecordUnsafe(entity);
+			if (foundArchetypeData == nullptr)
+			{
+				return std::nullopt;
+			}
+
+			const size_t oldChunkListIdx = foundArchetypeData->ArchetypeIndex;
+			ArchetypeSignature signature = ReferenceSignature(oldChunkListIdx);
+			for (const ComponentID componentID : componentIDs)
+			{
+				if (ComponentRegistry::DataOf(componentID).Info.bIsShared)
+				{
+					assert(false && "Shared component must be attached through SetShared.");
+					return std::nullopt;
+				}
+
+				if (signature.Contains(componentID))
+				{
+					return std::nullopt;
+				}
+
+				signature = signature.With(componentID);
+			}
+
+			std::vector<const void*> sharedValues = CollectSharedValues(signature, oldChunkListIdx);
+			const size_t newChunkListIdx = FindOrCreateChunkList(std::move(signature), std::move(sharedValues));
+			ArchetypeData& archetypeData = *FindRecordUnsafe(entity);
+			MoveAllocation(entity, archetypeData, newChunkListIdx, &FindOrCreateTransferPlan(oldChunkListIdx, newChunkListIdx));
+			return newChunkListIdx;
+		}
+
+		/** Column of component which starts from given row, tag component has no column so every rows share single empty object. */
+		template <ComponentType T>
+		[[nodiscard]] static T* SpawnColumnOf(const ChunkList& chunkList, const ChunkList::Allocation first) noexcept
+		{
+			if constexpr (IS_TAG_COMPONENT<T>)
+			{
+				static T tag;
+				return &tag;
+			}
+			else
+			{
+				return static_cast<T*>(chunkList.AddressOf(first, QueryComponentID<T>()));
+			}
+		}
+
+		/**
+		* Default construct component of consecutive rows which starts from given allocation.
+		* Declared fields of field split component are scattered from single default constructed object.
+		*/
+		void ConstructDefaultUnsafe(const size_t chunkListIdx, const ChunkList::Allocation first, const ComponentID componentID, const size_t numOfRows = 1)
+		{
+			const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+			if (dynamicComponentData.Info.bIsTag || first.IsFailedToAllocate())
+			{
+				return;
+			}
+
+			ChunkList& chunkList = ReferenceChunkList(chunkListIdx);
+			if (!dynamicComponentData.Info.Fields.empty())
+			{
+				for (size_t row = 0; row < numOfRows; ++row)
+				{
+					chunkList.ScatterFields(ChunkList::Allocation{ .ChunkIndex = first.ChunkIndex, .AllocationIndexOfEntity = first.AllocationIndexOfEntity + row }, componentID, dynamicComponentData.DefaultFieldSource);
+				}
+
+				return;
+			}
+
+			void* column = chunkList.AddressOf(first, componentID);
+			assert(column != nullptr);
+			dynamicComponentData.Construct(column, numOfRows);
+		}
+
+		/**
+		* Destroy component objects of every rows of chunk list, nothing happens if component does not live in chunk or it is trivially destructible.
+		* Consecutive occupied rows are destroyed as single range.
+		*/
+		void DestroyColumnUnsafe(const ChunkList& chunkList, const ComponentID componentID)
+		{
+			const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+			if (dynamicComponentData.Info.bIsTriviallyDestructible)
+			{
+				return;
+			}
+
+			for (size_t chunkIndex = 0; chunkIndex < chunkList.NumOfChunks(); ++chunkIndex)
+			{
+				std::byte* column = static_cast<std::byte*>(chunkList.ColumnOf(chunkIndex, componentID));
+				if (column == nullptr)
+				{
+					return;
+				}
+
+				const std::span<const Entity> entities = chunkList.EntitiesOf(chunkIndex);
+				for (size_t row = 0; row < entities.size();)
+				{
+					if (entities[row] == INVALID_ENTITY_HANDLE)
+					{
+						++row;
+						continue;
+					}
+
+					size_t runEnd = row + 1;
+					while (runEnd < entities.size() && entities[runEnd] != INVALID_ENTITY_HANDLE)
+					{
+						++runEnd;
+					}
+
+					dynamicComponentData.Destroy(column + (row * dynamicComponentData.Info.Size), runEnd - row);
+					row = runEnd;
+				}
+			}
+		}
+
+		/** Owner entities of every rows of chunk list, or entities which chunk list without storage keeps. */
+		[[nodiscard]] std::vector<Entity> EntitiesOfChunkListUnsafe(const size_t chunkListIdx) const
 		{
-			std::vector<Entity> remainEntities;
-			remainEntities.reserve(archetypeLUT.size());
-			for (auto& entityArchetypePair : archetypeLUT)
+			std::vector<Entity> entities;
+			const ChunkList& chunkList = chunkListLUT[chunkListIdx].second;
+			if (chunkList.HasStorage())
 			{
-				remainEntities.emplace_back(entityArchetypePair.first);
+				entities.reserve(chunkList.NumOfAllocations());
+				for (size_t chunkIndex = 0; chunkIndex < chunkList.NumOfChunks(); ++chunkIndex)
+				{
+					std::ranges::copy_if(chunkList.EntitiesOf(chunkIndex), std::back_inserter(entities), [](const Entity entity) { return entity != INVALID_ENTITY_HANDLE; });
+				}
 			}
-
-			for (const Entity entity : remainEntities)
+			else
 			{
-				Destroy(entity);
+				assert(chunkListIdx != 0 && "Entities of null archetype are not kept by chunk list.");
+				entities.assign(chunkList.EntitiesWithoutStorage().begin(), chunkList.EntitiesWithoutStorage().end());
 			}
+
+			return entities;
 		}
 
-		static ComponentArchive& Instance()
+		/**
+		* Move every entities of source chunk list into destination chunk list a whole source chunk at a time, source chunk list is empty after move.
+		* Consecutive rows are copied as single block per column, it never call any constructor or destructor.
+		* @param	onMovedRows		Called with first allocation and number of rows of each run of rows created in destination chunk list.
+		* @return	Number of moved entities.
+		*/
+		template <typename Function>
+		size_t MoveChunkListUnsafe(const size_t srcChunkListIdx, const size_t destChunkListIdx, Function&& onMovedRows)
 		{
-			std::call_once(instanceCreationOnceFlag, []()
+			const ChunkList::TransferPlan& plan = FindOrCreateTransferPlan(srcChunkListIdx, destChunkListIdx);
+			ChunkList& srcChunkList = ReferenceChunkList(srcChunkListIdx);
+			ChunkList& destChunkList = ReferenceChunkList(destChunkListIdx);
+			const uint64_t version = CurrentVersion();
+
+			std::vector<Entity> entities;
+			std::vector<size_t> srcRows;
+			const auto moveEntities = [&](const size_t srcChunkIndex)
 				{
-					instance.reset(new ComponentArchive());
-				});
+					if (!destChunkList.HasStorage())
+					{
+						for (const Entity entity : entities)
+						{
+							EnterChunkListWithoutStorageUnsafe(destChunkListIdx, entity, *FindRecordUnsafe(entity));
+						}
 
-			return *instance;
-		}
+						return;
+					}
 
-		static void DestroyInstance()
-		{
-			std::call_once(instanceDestructionOnceFlag, []()
+					size_t entityIndex = 0;
+					destChunkList.CreateBulk(entities, [&](const ChunkList::Allocation destFirst, const size_t numOfRows)
+						{
+							destChunkList.MarkChanged(destFirst.ChunkIndex, version);
+							for (size_t row = 0; row < numOfRows;)
+							{
+								size_t numOfConsecutiveRows = 1;
+								if (srcChunkList.HasStorage())
+								{
+									while (row + numOfConsecutiveRows < numOfRows && srcRows[entityIndex + row + numOfConsecutiveRows] == srcRows[entityIndex + row] + numOfConsecutiveRows)
+									{
+										++numOfConsecutiveRows;
+									}
+
+									ChunkList::RelocateRows(
+										srcChunkList, ChunkList::Allocation{ .ChunkIndex = srcChunkIndex, .AllocationIndexOfEntity = srcRows[entityIndex + row] },
+										destChunkList, ChunkList::Allocation{ .ChunkIndex = destFirst.ChunkIndex, .AllocationIndexOfEntity = destFirst.AllocationIndexOfEntity + row },
+										numOfConsecutiveRows, plan);
+								}
+
+								row += numOfConsecutiveRows;
+							}
+
+							for (size_t row = 0; row < numOfRows; ++row)
+							{
+								*FindRecordUnsafe(entities[entityIndex + row]) = ArchetypeData::Pack(
+									destChunkListIdx,
+									ChunkList::Allocation{ .ChunkIndex = destFirst.ChunkIndex, .AllocationIndexOfEntity = destFirst.AllocationIndexOfEntity + row });
+							}
+
+							onMovedRows(destFirst, numOfRows);
+							entityIndex += numOfRows;
+						});
+				};
+
+			if (!srcChunkList.HasStorage())
+			{
+				entities = EntitiesOfChunkListUnsafe(srcChunkListIdx);
+				moveEntities(0);
+				srcChunkList.Clear();
+				return entities.size();
+			}
+
+			size_t numOfMovedEntities = 0;
+			for (size_t chunkIndex = 0; chunkIndex < srcChunkList.NumOfChunks(); ++chunkIndex)
+			{
+				entities.clear();
+				srcRows.clear();
+				const std::span<const Entity> chunkEntities = srcChunkList.EntitiesOf(chunkIndex);
+				for (size_t row = 0; row < chunkEntities.size(); ++row)
 				{
-					delete instance.release();
-				});
+					if (chunkEntities[row] != INVALID_ENTITY_HANDLE)
+					{
+						entities.emplace_back(chunkEntities[row]);
+						srcRows.emplace_back(row);
+					}
+				}
+
+				moveEntities(chunkIndex);
+				numOfMovedEntities += entities.size();
+			}
+
+			srcChunkList.Clear();
+			return numOfMovedEntities;
 		}
 
 		template <ComponentType T>
-		void Archive()
+		void ConstructUnsafe(const size_t chunkListIdx, const ChunkList::Allocation allocation, T&& component)
 		{
-			dynamicComponentDataLUT[QueryComponentID<T>()] = DynamicComponentData{
-				.Info = ComponentInfo::Generate<T>(),
-				.DefaultConstructor = [](void* ptr) { new (ptr) T(); },
-				.Destructor = [](void* ptr) { reinterpret_cast<T*>(ptr)->~T(); }
-			};
+			const ComponentID componentID = QueryComponentID<T>();
+			if constexpr (FieldSplitComponentType<T>)
+			{
+				ReferenceChunkList(chunkListIdx).ScatterFields(allocation, componentID, &component);
+			}
+			else if constexpr (!IS_TAG_COMPONENT<T>)
+			{
+				void* address = ReferenceChunkList(chunkListIdx).AddressOf(allocation, componentID);
+				assert(address != nullptr);
+				new (address) T(std::move(component));
+			}
 		}
 
-		[[nodiscard]] bool Contains(const Entity entity, const ComponentID componentID) const
+		/**
+		* Shared values of archetype in order of archetype, taken from chunk list at given index.
+		* Value of overrideComponentID is replaced by(or inserted as) overrideValue.
+		*/
+		[[nodiscard]] std::vector<const void*> CollectSharedValues(const ArchetypeSignature& archetype, const size_t chunkListIdx, const ComponentID overrideComponentID = INVALID_COMPONENT_ID, const void* overrideValue = nullptr) const
 		{
-#if SY_ECS_THREAD_SAFE
-			ReadOnlyLock_t lock{ mutex };
-#endif
-			const auto foundArchetypeItr = archetypeLUT.find(entity);
-			if (foundArchetypeItr != archetypeLUT.end())
+			const ChunkList& chunkList = chunkListLUT.at(chunkListIdx).second;
+			std::vector<const void*> sharedValues;
+			for (const ComponentID componentID : archetype)
 			{
-				const auto& foundArchetypeData = (foundArchetypeItr->second);
-				return ReferenceArchetype(foundArchetypeData.ArchetypeIndex).contains(componentID);
+				const void* sharedValue = componentID == overrideComponentID ? overrideValue : chunkList.SharedValueOf(componentID);
+				if (sharedValue != nullptr)
+				{
+					sharedValues.emplace_back(sharedValue);
+				}
 			}
 
-			return false;
-		}
-
-		template <typename T>
-		[[nodiscard]] bool Contains(const Entity entity) const
-		{
-			return Contains(entity, QueryComponentID<T>());
+			return sharedValues;
 		}
 
-		[[nodiscard]] bool IsSameArchetype(const Entity lhs, const Entity rhs) const
+		/** Return address of stored value which equals to given value, stores copy of value if there is no equal value. */
+		const void* AcquireSharedValue(const ComponentID componentID, const void* value)
 		{
-#if SY_ECS_THREAD_SAFE
-			ReadOnlyLock_t lock{ mutex };
-#endif
-			const auto lhsItr = archetypeLUT.find(lhs);
-			const auto rhsItr = archetypeLUT.find(rhs);
-			if (lhsItr != archetypeLUT.end() && rhsItr != archetypeLUT.end())
+			const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+			std::vector<SharedValue>& sharedValues = sharedValueLUT[componentID];
+			for (SharedValue& sharedValue : sharedValues)
 			{
-				const auto& lhsArchetypeData = lhsItr->second;
-				const auto& rhsArchetypeData = rhsItr->second;
-				return lhsArchetypeData.ArchetypeIndex == rhsArchetypeData.ArchetypeIndex;
+				if (dynamicComponentData.Equal(sharedValue.Data, value))
+				{
+					++sharedValue.RefCount;
+					return sharedValue.Data;
+				}
 			}
 
-			// If both itrerator is entityLUT.end(), it means those are empty and at same time equal archetype.
-			return lhsItr == rhsItr;
+			void* newValue = ::operator new(dynamicComponentData.Info.Size, std::align_val_t{ dynamicComponentData.Info.Alignment });
+			dynamicComponentData.CopyConstructor(newValue, value);
+			sharedValues.emplace_back(SharedValue{ .Data = newValue, .RefCount = 1 });
+			return newValue;
 		}
 
-		[[nodiscard]] Archetype QueryArchetype(const Entity entity) const
+		/** @param	count	Number of entities which released value at once. */
+		void ReleaseSharedValue(const ComponentID componentID, const void* value, const size_t count = 1)
 		{
-#if SY_ECS_THREAD_SAFE
-			ReadOnlyLock_t lock{ mutex };
-#endif
-			if (archetypeLUT.contains(entity))
+			std::vector<SharedValue>& sharedValues = sharedValueLUT[componentID];
+			const auto found = std::find_if(sharedValues.begin(), sharedValues.end(), [value](const SharedValue& sharedValue) { return sharedValue.Data == value; });
+			assert(found != sharedValues.end() && found->RefCount >= count);
+			found->RefCount -= count;
+			if (found->RefCount == 0)
 			{
-				return ReferenceArchetype(archetypeLUT.find(entity)->second.ArchetypeIndex);
+				const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+				dynamicComponentData.Destroy(found->Data);
+				::operator delete(found->Data, std::align_val_t{ dynamicComponentData.Info.Alignment });
+				*found = sharedValues.back();
+				sharedValues.pop_back();
 			}
-
-			return Archetype();
 		}
 
-		/** Return nullptr, if component is already exist or failed to attach. */
-		bool Attach(const Entity entity, const ComponentID componentID, const bool bCallDefaultConstructor = true)
+		[[nodiscard]] const void* FindSharedValue(const ComponentID componentID, const void* value) const
 		{
-#if SY_ECS_THREAD_SAFE
-			WriteLock_t lock{ mutex };
-#endif
-			Component* result = nullptr;
-			if (!ContainsUnsafe(entity, componentID))
+			const DynamicComponentData& dynamicComponentData = ComponentRegistry::DataOf(componentID);
+			for (const SharedValue& sharedValue : sharedValueLUT[componentID])
 			{
-				if (!archetypeLUT.contains(entity))
+				if (dynamicComponentData.Equal(sharedValue.Data, value))
 				{
-					archetypeLUT[entity] = ArchetypeData();
+					return sharedValue.Data;
 				}
+			}
 
-				ArchetypeData& archetypeData = archetypeLUT[entity];
-				Archetype archetype = ReferenceArchetype(archetypeData.ArchetypeIndex);
-				archetype.insert(componentID);
+			return nullptr;
+		}
 
-				const auto newChunkListIdx = FindOrCreateChunkList(archetype);
-				const ChunkList::Allocation newAllocation = ReferenceChunkList(newChunkListIdx).Create();
-				if (!newAllocation.IsFailedToAllocate() && !ReferenceArchetype(archetypeData.ArchetypeIndex).empty())
+		void DefragmentationUnsafe(const size_t numOfWorkers)
+		{
+			const uint64_t version = CurrentVersion();
+			ForEachChunkListParallel(numOfWorkers, [this, version](ChunkList& chunkList)
 				{
-					const auto oldChunkListIdx = FindOrCreateChunkList(ReferenceArchetype(archetypeData.ArchetypeIndex));
-					ChunkList::MoveData(
-						ReferenceChunkList(oldChunkListIdx), archetypeLUT[entity].Allocation,
-						ReferenceChunkList(newChunkListIdx), newAllocation);
-				}
-
-				archetypeData.Allocation = newAllocation;
-				archetypeData.ArchetypeIndex = newChunkListIdx;
+					/** Entities of different chunk lists never overlap and lookup never inserts, so workers can fix up archetype data without lock. */
+					for (const ChunkList::Relocation& relocation : chunkList.Compact(version))
+					{
+						FindRecordUnsafe(relocation.Owner)->SetAllocation(relocation.NewAllocation);
+					}
+				});
+		}
 
-				result = static_cast<Component*>(ReferenceChunkList(newChunkListIdx).AddressOf(newAllocation, componentID));
-				if (result != nullptr && bCallDefaultConstructor)
+		/**
+		* Call function(ChunkList&) for every chunk lists on given number of workers, each chunk list is visited by single worker.
+		* Chunk lists which have more chunks are handed out first to balance load of workers.
+		*/
+		template <typename Function>
+		void ForEachChunkListParallel(const size_t numOfWorkers, Function&& function)
+		{
+			std::vector<size_t> chunkListIndices;
+			chunkListIndices.reserve(chunkListLUT.size());
+			for (size_t idx = 1; idx < chunkListLUT.size(); ++idx) // Except null archetype
+			{
+				if (ReferenceChunkList(idx).NumOfChunks() > 0)
 				{
-					const DynamicComponentData& dynamicComponentData = dynamicComponentDataLUT[componentID];
-					dynamicComponentData.DefaultConstructor(result);
+					chunkListIndices.emplace_back(idx);
 				}
 			}
 
-			return result != nullptr;
-		}
+			std::sort(chunkListIndices.begin(), chunkListIndices.end(), [this](const size_t lhs, const size_t rhs)
+				{
+					return chunkListLUT[lhs].second.NumOfChunks() > chunkListLUT[rhs].second.NumOfChunks();
+				});
 
-		template <ComponentType T, typename... Args>
-		bool Attach(const Entity entity, Args&&... args)
-		{
-			constexpr bool bShouldCallDefaultConstructor = (sizeof...(Args) == 0);
-			constexpr ComponentID componentID = QueryComponentID<T>();
-			Component* result = nullptr;
+			std::atomic<size_t> nextIndex = 0;
+			const auto worker = [this, &chunkListIndices, &nextIndex, &function]()
+				{
+					for (size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed); index < chunkListIndices.size(); index = nextIndex.fetch_add(1, std::memory_order_relaxed))
+					{
+						function(ReferenceChunkList(chunkListIndices[index]));
+					}
+				};
 
-#if SY_ECS_THREAD_SAFE
-			WriteLock_t lock{ mutex };
-#endif
-			if (!ContainsUnsafe(entity, componentID))
+			std::vector<std::jthread> workers;
+			const size_t numOfThreads = std::min(std::max<size_t>(numOfWorkers, 1), chunkListIndices.size());
+			for (size_t workerIndex = 1; workerIndex < numOfThreads; ++workerIndex)
 			{
-				if (!archetypeLUT.contains(entity))
-				{
-					archetypeLUT[entity] = ArchetypeData();
-				}
+				workers.emplace_back(worker);
+			}
 
-				ArchetypeData& archetypeData = archetypeLUT[entity];
-				Archetype archetype = ReferenceArchetype(archetypeData.ArchetypeIndex);
-				archetype.insert(componentID);
+			worker();
+		}
 
-				const auto newChunkListIdx = FindOrCreateChunkList(archetype);
-				const ChunkList::Allocation newAllocation = ReferenceChunkList(newChunkListIdx).Create();
-				if (!newAllocation.IsFailedToAllocate() && !ReferenceArchetype(archetypeData.ArchetypeIndex).empty())
+		/** Return size of chunk list LUT if there is no fragmented chunk list. */
+		[[nodiscard]] size_t FindMostFragmentedChunkList() const
+		{
+			size_t mostFragmentedIdx = chunkListLUT.size();
+			float lowestFillRatio = std::numeric_limits<float>::max();
+			for (size_t idx = 1; idx < chunkListLUT.size(); ++idx) // Except null archetype
+			{
+				const ChunkList& chunkList = chunkListLUT[idx].second;
+				if (chunkList.IsFragmented() && chunkList.FillRatio() < lowestFillRatio)
 				{
-					const auto oldChunkListIdx = FindOrCreateChunkList(ReferenceArchetype(archetypeData.ArchetypeIndex));
-					ChunkList::MoveData(
-						ReferenceChunkList(oldChunkListIdx), archetypeLUT[entity].Allocation,
-						ReferenceChunkList(newChunkListIdx), newAllocation);
+					mostFragmentedIdx = idx;
+					lowestFillRatio = chunkList.FillRatio();
 				}
+			}
 
-				archetypeData.Allocation = newAllocation;
-				archetypeData.ArchetypeIndex = newChunkListIdx;
+			return mostFragmentedIdx;
+		}
 
-				result = static_cast<Component*>(ReferenceChunkList(newChunkListIdx).AddressOf(newAllocation, componentID));
-				if (result != nullptr)
+		template <typename Predicate, typename Function>
+		void ForEachChunkUnsafe(const Archetype& filter, Predicate&& chunkListPredicate, Function&& function, const uint64_t changedSinceVersion)
+		{
+			const uint64_t version = CurrentVersion();
+			std::array<uint64_t, Chunk::MAX_NUM_OF_ALLOCATIONS / std::numeric_limits<uint64_t>::digits> enabledRowMask;
+			for (size_t idx = 1; idx < chunkListLUT.size(); ++idx) // Except null archetype
+			{
+				if (ReferenceSignature(idx).Includes(filter) && chunkListPredicate(ReferenceChunkList(idx)))
 				{
-					if (bShouldCallDefaultConstructor)
+					ChunkList& chunkList = ReferenceChunkList(idx);
+					const bool bHasEnableableFilter = std::ranges::any_of(filter, [&chunkList](const ComponentID componentID) { return chunkList.IsEnableable(componentID); });
+					for (size_t chunkIndex = 0; chunkIndex < chunkList.NumOfChunks(); ++chunkIndex)
 					{
-						const DynamicComponentData& dynamicComponentData = dynamicComponentDataLUT[componentID];
-						dynamicComponentData.DefaultConstructor(result);
-					}
-					else
-					{
-						new (result) T(std::forward<Args>(args)...);
+						if (!chunkList.IsChunkEmpty(chunkIndex) && (changedSinceVersion == 0 || HasChangedSince(chunkList, chunkIndex, filter, changedSinceVersion)))
+						{
+							if (!bHasEnableableFilter)
+							{
+								ChunkView chunkView{ chunkList, chunkIndex, version };
+								function(chunkView);
+							}
+							else if (BuildEnabledRowMask(chunkList, chunkIndex, filter, enabledRowMask))
+							{
+								ChunkView chunkView{ chunkList, chunkIndex, version, enabledRowMask.data() };
+								function(chunkView);
+							}
+						}
 					}
 				}
 			}
-
-			return result != nullptr;
 		}
 
-		void Detach(const Entity entity, const ComponentID componentID)
+		/**
+		* Rows of new allocation are written by move or construction, so its chunk is stamped as changed.
+		* Return failed allocation if chunk list has no storage.
+		*/
+		ChunkList::Allocation CreateAllocation(const size_t chunkListIdx, const Entity entity)
 		{
-#if SY_ECS_THREAD_SAFE
-			WriteLock_t lock{ mutex };
-#endif
-			if (ContainsUnsafe(entity, componentID))
+			ChunkList& chunkList = ReferenceChunkList(chunkListIdx);
+			if (!chunkList.HasStorage())
 			{
-				ArchetypeData& archetypeData = archetypeLUT[entity];
-				Archetype archetype = ReferenceArchetype(archetypeData.ArchetypeIndex);
-				archetype.erase(componentID);
-
-				const auto oldChunkListIdx = FindOrCreateChunkList(ReferenceArchetype(archetypeData.ArchetypeIndex));
-				const ChunkList::Allocation oldAllocation = archetypeData.Allocation;
-				void* detachComponentPtr = ReferenceChunkList(oldChunkListIdx).AddressOf(oldAllocation, componentID);
+				return ChunkList::Allocation();
+			}
 
-				const DynamicComponentData& dynamicComponentData = dynamicComponentDataLUT[componentID];
-				dynamicComponentData.Destructor(detachComponentPtr);
+			const ChunkList::Allocation allocation = chunkList.Create(entity);
+			chunkList.MarkChanged(allocation.ChunkIndex, CurrentVersion());
+			return allocation;
+		}
 
-				if (!archetype.empty())
+		/**
+		* Move entity with its data to chunk list at given index, rows are allocated or destroyed when entity enters or leaves chunk list which has storage.
+		* @param	plan	Transfer plan from current chunk list of entity to new chunk list, it is built on demand if nullptr.
+		*/
+		void MoveAllocation(const Entity entity, ArchetypeData& archetypeData, const size_t newChunkListIdx, const ChunkList::TransferPlan* plan = nullptr)
+		{
+			LeaveChunkListWithoutStorageUnsafe(archetypeData);
+			const ChunkList::Allocation oldAllocation = archetypeData.Allocation();
+			const ChunkList::Allocation newAllocation = CreateAllocation(newChunkListIdx, entity);
+			if (!oldAllocation.IsFailedToAllocate())
+			{
+				ChunkList& oldChunkList = ReferenceChunkList(archetypeData.ArchetypeIndex);
+				Entity movedEntity = INVALID_ENTITY_HANDLE;
+				if (newAllocation.IsFailedToAllocate())
+				{
+					movedEntity = oldChunkList.Destroy(oldAllocation);
+				}
+				else if (plan != nullptr)
 				{
-					const auto newChunkListIdx = FindOrCreateChunkList(archetype);
-					const ChunkList::Allocation newAllocation = ReferenceChunkList(newChunkListIdx).Create();
-					ChunkList::MoveData(
-						ReferenceChunkList(oldChunkListIdx), oldAllocation,
-						ReferenceChunkList(newChunkListIdx), newAllocation);
-					archetypeData.Allocation = newAllocation;
-					archetypeData.ArchetypeIndex = newChunkListIdx;
+					movedEntity = ChunkList::MoveData(oldChunkList, oldAllocation, ReferenceChunkList(newChunkListIdx), newAllocation, *plan);
 				}
 				else
 				{
-					ReferenceChunkList(oldChunkListIdx).Destroy(oldAllocation);
-					archetypeData = ArchetypeData();
+					movedEntity = ChunkList::MoveData(oldChunkList, oldAllocation, ReferenceChunkList(newChunkListIdx), newAllocation);
 				}
+				UpdateMovedAllocation(movedEntity, oldAllocation);
+			}
+
+			if (newAllocation.IsFailedToAllocate())
+			{
+				EnterChunkListWithoutStorageUnsafe(newChunkListIdx, entity, archetypeData);
+				return;
 			}
+
+			archetypeData.SetAllocation(newAllocation);
+			archetypeData.ArchetypeIndex = static_cast<uint32_t>(newChunkListIdx);
 		}
 
-		template <ComponentType T>
-		void Detach(const Entity entity)
+		/** Entity of null archetype is not kept by chunk list, because bulk operations never visit null archetype. */
+		void EnterChunkListWithoutStorageUnsafe(const size_t chunkListIdx, const Entity entity, ArchetypeData& archetypeData)
 		{
-			Detach(entity, QueryComponentID<T>());
+			archetypeData = ArchetypeData::Pack(chunkListIdx);
+			if (chunkListIdx != 0)
+			{
+				archetypeData.SetSlotWithoutStorage(ReferenceChunkList(chunkListIdx).AddEntityWithoutStorage(entity));
+			}
 		}
 
-		/**
-		* @brief	Return Deferred Access Handle Object.
-		*/
-		template <ComponentType T>
-		[[nodiscard]] ComponentHandle<T> GetHandle(const Entity entity) const noexcept
+		/** Last entity of chunk list takes slot of leaving entity. */
+		void LeaveChunkListWithoutStorageUnsafe(const ArchetypeData& archetypeData)
 		{
-			return ComponentHandle<T>(*this, entity);
+			ChunkList& chunkList = ReferenceChunkList(archetypeData.ArchetypeIndex);
+			if (archetypeData.ArchetypeIndex == 0 || chunkList.HasStorage())
+			{
+				return;
+			}
+
+			const size_t slot = archetypeData.SlotWithoutStorage();
+			if (const Entity movedEntity = chunkList.RemoveEntityWithoutStorage(slot); movedEntity != INVALID_ENTITY_HANDLE)
+			{
+				FindRecordUnsafe(movedEntity)->SetSlotWithoutStorage(slot);
+			}
 		}
 
-		[[nodiscard]] Component* Get(const Entity entity, const ComponentID componentID) const
+		/** Entity which moved to keep dense chunk list contiguous, now lives in given allocation. */
+		void UpdateMovedAllocation(const Entity movedEntity, const ChunkList::Allocation allocation)
 		{
-#if SY_ECS_THREAD_SAFE
-			ReadOnlyLock_t lock{ mutex };
-#endif
-			if (ContainsUnsafe(entity, componentID))
+			if (movedEntity != INVALID_ENTITY_HANDLE)
 			{
-				const auto& archetypeData = archetypeLUT.find(entity)->second;
-				const Archetype& archetype = ReferenceArchetype(archetypeData.ArchetypeIndex);
-				const ChunkList::Allocation& allocation = archetypeData.Allocation;
-				for (size_t idx = 1; idx < chunkListLUT.size(); ++idx) // Except null archetype
+				ArchetypeData* archetypeData = FindRecordUnsafe(movedEntity);
+				assert(archetypeData != nullptr);
+				archetypeData->SetAllocation(allocation);
+				ReferenceChunkList(archetypeData->ArchetypeIndex).MarkChanged(allocation.ChunkIndex, CurrentVersion());
+			}
+		}
+
+		/** AND enabled masks of enableable filter components. Return false if no row is enabled. */
+		static bool BuildEnabledRowMask(const ChunkList& chunkList, const size_t chunkIndex, const Archetype& filter, std::array<uint64_t, Chunk::MAX_NUM_OF_ALLOCATIONS / std::numeric_limits<uint64_t>::digits>& enabledRowMask) noexcept
+		{
+			const size_t numOfMasks = chunkList.NumOfEnabledMasksPerChunk();
+			std::fill_n(enabledRowMask.begin(), numOfMasks, ~uint64_t(0));
+			for (const ComponentID componentID : filter)
+			{
+				if (const uint64_t* enabledMask = chunkList.EnabledMaskOf(chunkIndex, componentID); enabledMask != nullptr)
 				{
-					if (archetypeData.ArchetypeIndex == idx)
+					for (size_t maskIndex = 0; maskIndex < numOfMasks; ++maskIndex)
 					{
-						const auto& chunkList = chunkListLUT.at(idx).second;
-						return static_cast<Component*>(chunkList.AddressOf(allocation, componentID));
+						enabledRowMask[maskIndex] &= std::atomic_ref<uint64_t>(const_cast<uint64_t&>(enabledMask[maskIndex])).load(std::memory_order_relaxed);
 					}
 				}
 			}
 
-			return nullptr;
+			return std::any_of(enabledRowMask.cbegin(), enabledRowMask.cbegin() + numOfMasks, [](const uint64_t mask) { return mask != 0; });
 		}
 
-		template <ComponentType T>
-		[[nodiscard]] T* Get(const Entity entity) const
+		[[nodiscard]] static bool HasChangedSince(const ChunkList& chunkList, const size_t chunkIndex, const Archetype& filter, const uint64_t version) noexcept
 		{
-			return reinterpret_cast<T*>(Get(entity, QueryComponentID<T>()));
+			if (filter.empty())
+			{
+				return chunkList.HasChangedSince(chunkIndex, version);
+			}
+
+			return std::ranges::any_of(filter, [&chunkList, chunkIndex, version](const ComponentID componentID)
+				{
+					return chunkList.ChangeVersionOf(chunkIndex, componentID) > version;
+				});
 		}
 
-		void Destroy(const Entity entity)
+		static EntityReservation& LocalReservation()
 		{
-#if SY_ECS_THREAD_SAFE
-			WriteLock_t lock(mutex);
-#endif
-			if (archetypeLUT.contains(entity))
+			thread_local EntityReservation reservation;
+			return reservation;
+		}
+
+		/** @return	First index of given number of consecutive indices, their record pages are allocated here. */
+		uint64_t ReserveEntityIndices(const size_t count)
+		{
+			const uint64_t firstIndex = nextEntityIndex.fetch_add(count, std::memory_order_relaxed);
+			assert(firstIndex + count <= std::numeric_limits<EntityIndex>::max() && "Number of entities exceeds range of entity index.");
+			for (size_t pageIndex = firstIndex / ENTITY_RECORDS_PER_PAGE; pageIndex <= (firstIndex + count - 1) / ENTITY_RECORDS_PER_PAGE; ++pageIndex)
 			{
-				const auto& archetypeData = archetypeLUT[entity];
-				const Archetype& archetype = ReferenceArchetype(archetypeData.ArchetypeIndex);
-				if (!archetype.empty())
+				if (entityRecordPages[pageIndex].load(std::memory_order_acquire) == nullptr)
 				{
-					const auto chunkList = FindOrCreateChunkList(archetype);
-					const ChunkList::Allocation oldAllocation = archetypeData.Allocation;
-					for (const ComponentID componentID : archetype)
+					std::lock_guard lock{ entityRecordPageMutex };
+					if (entityRecordPages[pageIndex].load(std::memory_order_relaxed) == nullptr)
 					{
-						void* detachComponentPtr = ReferenceChunkList(chunkList).AddressOf(oldAllocation, componentID);
-						const DynamicComponentData& dynamicComponentData = dynamicComponentDataLUT[componentID];
-						dynamicComponentData.Destructor(detachComponentPtr);
+						entityRecordPageOwners.emplace_back(std::make_unique<EntityRecord[]>(ENTITY_RECORDS_PER_PAGE));
+						entityRecordPages[pageIndex].store(entityRecordPageOwners.back().get(), std::memory_order_release);
 					}
-
-					ReferenceChunkList(chunkList).Destroy(oldAllocation);
 				}
-
-				archetypeLUT.erase(entity);
 			}
+
+			return firstIndex;
 		}
 
-		/**
-		* Trying to de-fragment 'entire' chunk list and chunks(except not fragmented chunk which is full)
-		* It maybe will nullyfies any references, pointers that acquired from Attach and Get methods.
-		*/
-		void Defragmentation()
+		/** Handles which other threads returned are taken before reserving new indices. */
+		void RefillReservation(EntityReservation& reservation)
 		{
-#if SY_ECS_THREAD_SAFE
-			WriteLock_t lock(mutex);
-#endif
-			for (auto& archetypeLUTPair : archetypeLUT)
+			if (numOfPooledEntities.load(std::memory_order_relaxed) > 0)
 			{
-				const Entity entity = archetypeLUTPair.first;
-				auto& archetypeData = archetypeLUTPair.second;
-				const Archetype& archetype = ReferenceArchetype(archetypeData.ArchetypeIndex);
-				if (!archetype.empty() && !archetypeData.Allocation.IsFailedToAllocate())
+				std::lock_guard lock{ entityPoolMutex };
+				const size_t numOfTaken = std::min(ENTITY_RESERVATION_BLOCK_SIZE, entityPool.size());
+				reservation.Recycled.insert(reservation.Recycled.end(), entityPool.end() - numOfTaken, entityPool.end());
+				entityPool.resize(entityPool.size() - numOfTaken);
+				numOfPooledEntities.store(entityPool.size(), std::memory_order_relaxed);
+				if (numOfTaken > 0)
 				{
-					const size_t chunkListIdx = FindChunkList(archetype);
-					if (chunkListIdx != chunkListLUT.size())
-					{
-						ChunkList& chunkListRef = ReferenceChunkList(chunkListIdx);
-						const size_t freeChunkIndex = chunkListRef.FreeChunkIndex();
-						if (freeChunkIndex <= archetypeData.Allocation.ChunkIndex)
-						{
-							const ChunkList::Allocation newAllocation = chunkListRef.Create();
-							ChunkList::MoveData(
-								chunkListRef, archetypeData.Allocation,
-								chunkListRef, newAllocation);
-
-							archetypeData.Allocation = newAllocation;
-						}
-					}
+					return;
 				}
 			}
+
+			reservation.NextIndex = ReserveEntityIndices(ENTITY_RESERVATION_BLOCK_SIZE);
+			reservation.EndIndex = reservation.NextIndex + ENTITY_RESERVATION_BLOCK_SIZE;
 		}
 
-		size_t ShrinkToFit(const bool bPerformShrinkAfterDefrag = true)
+		/**
+		* Thread which destroys many entities hands surplus over to global pool, so recycled handles are not stuck in single thread.
+		* Rest of them are returned when thread exits.
+		*/
+		void RecycleEntity(const Entity entity)
 		{
-			if (bPerformShrinkAfterDefrag)
+			EntityReservation& reservation = LocalReservation();
+			reservation.Recycled.emplace_back(entity);
+			if (reservation.Recycled.size() >= (ENTITY_RESERVATION_BLOCK_SIZE * 2))
 			{
-				Defragmentation();
+				PoolEntities(std::span<const Entity>(reservation.Recycled).first(ENTITY_RESERVATION_BLOCK_SIZE));
+				reservation.Recycled.erase(reservation.Recycled.begin(), reservation.Recycled.begin() + ENTITY_RESERVATION_BLOCK_SIZE);
 			}
+		}
 
-#if SY_ECS_THREAD_SAFE
-			WriteLock_t lock(mutex);
-#endif
-			chunkListLUT.shrink_to_fit();
+		void PoolEntities(const std::span<const Entity> entities)
+		{
+			std::lock_guard lock{ entityPoolMutex };
+			entityPool.insert(entityPool.end(), entities.begin(), entities.end());
+			numOfPooledEntities.store(entityPool.size(), std::memory_order_relaxed);
+		}
 
-			size_t reduced = 0;
-			for (auto& chunkList : chunkListLUT | views::values)
+		void ReturnReservation(EntityReservation& reservation)
+		{
+			std::lock_guard lock{ entityPoolMutex };
+			entityPool.insert(entityPool.end(), reservation.Recycled.begin(), reservation.Recycled.end());
+			for (uint64_t index = reservation.NextIndex; index < reservation.EndIndex; ++index)
 			{
-				reduced += chunkList.ShrinkToFit();
+				entityPool.emplace_back(MakeEntity(static_cast<EntityIndex>(index), FIRST_ENTITY_GENERATION));
 			}
 
-			return reduced;
+			numOfPooledEntities.store(entityPool.size(), std::memory_order_relaxed);
+			reservation.NextIndex = 0;
+			reservation.EndIndex = 0;
+			reservation.Recycled.clear();
 		}
 
-	private:
-		ComponentArchive() noexcept(false)
+		/** nullptr if page of index is not allocated yet, so index has never been reserved. */
+		[[nodiscard]] EntityRecord* FindEntityRecord(const EntityIndex index) const noexcept
 		{
-			chunkListLUT.emplace_back(Archetype(), ChunkList({}));
+			EntityRecord* page = entityRecordPages[index / ENTITY_RECORDS_PER_PAGE].load(std::memory_order_acquire);
+			return page != nullptr ? page + (index % ENTITY_RECORDS_PER_PAGE) : nullptr;
 		}
 
-		size_t FindOrCreateChunkList(const Archetype& archetype)
+		/** Index of entity must be reserved, so its page exists. */
+		[[nodiscard]] EntityRecord& RecordOf(const Entity entity) const noexcept
 		{
-			size_t idx = 0;
-			for (; idx < chunkListLUT.size(); ++idx)
+			EntityRecord* record = FindEntityRecord(IndexOf(entity));
+			assert(record != nullptr);
+			return *record;
+		}
+
+		/** Only thread which owns index writes its generation, records of indices which other threads reserved stay unissued. */
+		void IssueRecord(const Entity entity)
+		{
+			EntityRecord& record = RecordOf(entity);
+			assert(record.Generation.load(std::memory_order_relaxed) == UNISSUED_ENTITY_GENERATION && "Handle of entity is issued twice.");
+			record.Generation.store(GenerationOf(entity), std::memory_order_release);
+		}
+
+		[[nodiscard]] bool IsIssuedUnsafe(const Entity entity) const noexcept
+		{
+			const EntityRecord* record = FindEntityRecord(IndexOf(entity));
+			return record != nullptr && GenerationOf(entity) != UNISSUED_ENTITY_GENERATION && record->Generation.load(std::memory_order_acquire) == GenerationOf(entity);
+		}
+
+		/**
+		* Record of entity which will be written, entity which never had any component gets null archetype here.
+		* nullptr if entity is destroyed or handle is not issued.
+		*/
+		[[nodiscard]] ArchetypeData* AcquireRecordUnsafe(const Entity entity)
+		{
+			if (!IsIssuedUnsafe(entity))
 			{
-				if (chunkListLUT.at(idx).first == archetype)
-				{
-					break;
-				}
+				return nullptr;
 			}
 
-			if (idx == chunkListLUT.size())
+			EntityRecord& record = RecordOf(entity);
+			if (record.Data.ArchetypeIndex == NO_ARCHETYPE)
 			{
-				chunkListLUT.emplace_back(archetype, ChunkList(RetrieveComponentInfosFromArchetype(archetype)));
+				record.Data = ArchetypeData();
 			}
 
-			return idx;
+			return &record.Data;
 		}
 
-		[[nodiscard]] size_t FindChunkList(const Archetype& archetype) const
+		/** Single array access, nullptr if entity is destroyed, has never had any component or handle is not issued. */
+		[[nodiscard]] ArchetypeData* FindRecordUnsafe(const Entity entity) noexcept
 		{
-			size_t idx = 0;
-			for (; idx < chunkListLUT.size(); ++idx)
+			if (!IsIssuedUnsafe(entity))
 			{
-				if (chunkListLUT.at(idx).first == archetype)
-				{
-					return idx;
-				}
+				return nullptr;
 			}
 
-			return idx;
+			EntityRecord& record = RecordOf(entity);
+			return record.Data.ArchetypeIndex != NO_ARCHETYPE ? &record.Data : nullptr;
 		}
 
-		[[nodiscard]] bool ContainsUnsafe(const Entity entity, const ComponentID componentID) const
+		[[nodiscard]] const ArchetypeData* FindRecordUnsafe(const Entity entity) const noexcept
 		{
-			const auto foundArchetypeItr = archetypeLUT.find(entity);
-			if (foundArchetypeItr != archetypeLUT.end())
-			{
-				const auto& foundArchetypeData = (foundArchetypeItr->second);
-				return ReferenceArchetype(foundArchetypeData.ArchetypeIndex).contains(componentID);
-			}
+			return const_cast<ComponentArchive*>(this)->FindRecordUnsafe(entity);
+		}
 
-			return false;
+		/**
+		* Record stays unissued until recycled handle with next generation is issued, so handles of destroyed entity never match it again.
+		* @return	Handle which reuses index of entity with next generation.
+		*/
+		[[nodiscard]] Entity ReleaseRecordUnsafe(const Entity entity)
+		{
+			EntityRecord& record = RecordOf(entity);
+			const EntityGeneration generation = record.Generation.load(std::memory_order_relaxed);
+			const EntityGeneration nextGeneration = (generation == std::numeric_limits<EntityGeneration>::max()) ? FIRST_ENTITY_GENERATION : generation + 1;
+			record.Data = ArchetypeData{ .ArchetypeIndex = NO_ARCHETYPE };
+			record.Generation.store(UNISSUED_ENTITY_GENERATION, std::memory_order_relaxed);
+			return MakeEntity(IndexOf(entity), nextGeneration);
+		}
+
+		[[nodiscard]] bool ContainsUnsafe(const Entity entity, const ComponentID componentID) const
+		{
+			const ArchetypeData* archetypeData = FindRecordUnsafe(entity);
+			return archetypeData != nullptr && ReferenceSignature(archetypeData->ArchetypeIndex).Contains(componentID);
 		}
 
 		/**
@@ -923,15 +4513,15 @@ namespace sy
 			return chunkListLUT.at(idx).second;
 		}
 
-		[[nodiscard]] const Archetype& ReferenceArchetype(const size_t idx) const { return chunkListLUT.at(idx).first; }
+		[[nodiscard]] const ArchetypeSignature& ReferenceSignature(const size_t idx) const { return chunkListLUT.at(idx).first; }
 
-		[[nodiscard]] std::vector<ComponentInfo> RetrieveComponentInfosFromArchetype(const Archetype& archetype) const
+		[[nodiscard]] std::vector<ComponentInfo> RetrieveComponentInfosFromArchetype(const ArchetypeSignature& archetype) const
 		{
 			std::vector<ComponentInfo> res{ };
-			res.reserve(archetype.size());
+			res.reserve(archetype.Size());
 			for (const ComponentID componentID : archetype)
 			{
-				const auto& foundComponentDynamicData = dynamicComponentDataLUT.find(componentID)->second;
+				const auto& foundComponentDynamicData = ComponentRegistry::DataOf(componentID);
 				res.emplace_back(foundComponentDynamicData.Info);
 			}
 
@@ -942,18 +4532,52 @@ namespace sy
 		static inline std::unique_ptr<ComponentArchive> instance;
 		static inline std::once_flag instanceCreationOnceFlag;
 		static inline std::once_flag instanceDestructionOnceFlag;
+		/** Guards instance against reservations which are returned at thread exit. */
+		static inline std::mutex instanceLifetimeMutex;
 #if SY_ECS_THREAD_SAFE
 		mutable Mutex_t mutex;
 #endif
-		robin_hood::unordered_flat_map<ComponentID, DynamicComponentData> dynamicComponentDataLUT;
-		robin_hood::unordered_flat_map<Entity, ArchetypeData> archetypeLUT;
-		std::vector<std::pair<Archetype, ChunkList>> chunkListLUT;
+		/** Page of records indexed by index of entity handle / ENTITY_RECORDS_PER_PAGE, page is allocated when its first index is reserved. */
+		std::unique_ptr<std::atomic<EntityRecord*>[]> entityRecordPages = std::make_unique<std::atomic<EntityRecord*>[]>(NUM_OF_ENTITY_RECORD_PAGES);
+		std::mutex entityRecordPageMutex;
+		std::vector<std::unique_ptr<EntityRecord[]>> entityRecordPageOwners;
+		/** Global source of entity indices, threads reserve indices from it as block. */
+		std::atomic<uint64_t> nextEntityIndex = 0;
+		/** Handles which threads returned, threads refill their reservation from it before reserving new indices. */
+		std::mutex entityPoolMutex;
+		std::vector<Entity> entityPool;
+		std::atomic<size_t> numOfPooledEntities = 0;
+		/** Values are never relocated, so chunk lists identify shared value by its address. */
+		std::array<std::vector<SharedValue>, MAX_NUM_OF_COMPONENTS> sharedValueLUT;
+		ChunkStorageMode chunkStorageMode = ChunkStorageMode::Sparse;
+		/** Chunk list which DefragmentStep is compacting, out of range if it has to pick new one. */
+		size_t defragmentingChunkListIdx = std::numeric_limits<size_t>::max();
+		/** Starts from 1, so version 0 means 'never written' and ForEachChunk with 0 visits every chunks. */
+		std::atomic<uint64_t> globalVersion = 1;
+		/** Must be declared before chunk list LUT, chunk lists return their chunks to allocator on destruction. */
+		ChunkAllocator chunkAllocator;
+		std::vector<std::pair<ArchetypeSignature, ChunkList>> chunkListLUT;
+		/** Index of chunk list in chunk list LUT. */
+		robin_hood::unordered_flat_map<ChunkListKey, size_t, ChunkListKeyHash> chunkListIndexLUT;
+		/** Outgoing edges of chunk list at same index of chunk list LUT. */
+		std::vector<ArchetypeEdges> edgeLUT;
 
 	};
 
 	template <ComponentType T>
 	using ComponentHandle = ComponentArchive::ComponentHandle<T>;
 
+	inline Entity GenerateEntity()
+	{
+		return ComponentArchive::Instance().CreateEntity();
+	}
+
+	/** Fill given entities with new handles at once. */
+	inline void GenerateEntities(const std::span<Entity> entities)
+	{
+		ComponentArchive::Instance().CreateEntities(entities);
+	}
+
 	namespace Filter
 	{
 		static std::vector<Entity> All(const ComponentArchive& archive, const std::vector<Entity>& entities, const Archetype& filter)
@@ -963,7 +4587,7 @@ namespace sy
 
 			for (const Entity entity : entities)
 			{
-				const Archetype& entityArchetype = archive.QueryArchetype(entity);
+				const Archetype& entityArchetype = archive.QueryEnabledArchetype(entity);
 				if (!entityArchetype.empty() &&
 					std::includes(
 						entityArchetype.cbegin(), entityArchetype.cend(),
@@ -985,7 +4609,7 @@ namespace sy
 
 			for (const Entity entity : entities)
 			{
-				const Archetype& entityArchetype = archive.QueryArchetype(entity);
+				const Archetype& entityArchetype = archive.QueryEnabledArchetype(entity);
 				if (!entityArchetype.empty())
 				{
 					Archetype intersection = {};
@@ -1013,8 +4637,9 @@ namespace sy
 
 			for (const Entity entity : entities)
 			{
-				const Archetype& entityArchetype = archive.QueryArchetype(entity);
-				if (!entityArchetype.empty())
+				/** Entity which every components are disabled still exists, so check emptiness with whole archetype. */
+				const Archetype& entityArchetype = archive.QueryEnabledArchetype(entity);
+				if (!entityArchetype.empty() || !archive.QueryArchetype(entity).empty())
 				{
 					Archetype intersection = {};
 					std::set_intersection(
@@ -1061,23 +4686,40 @@ namespace sy
 
 #define COMPONENT_TYPE_HASH(x) sy::utils::ELFHash(#x)
 
+/** Component type is registered and gets its ID when it is queried at first time, so declaration does not need definition in translation unit. */
 #define DeclareComponent(ComponentType) \
-struct ComponentType##Registeration \
-{ \
-	ComponentType##Registeration() \
-	{ \
-	auto& archive = sy::ComponentArchive::Instance(); \
-	archive.Archive<ComponentType>(); \
-	}	\
-	private: \
-		static ComponentType##Registeration registeration; \
-}; \
 template <> \
-constexpr sy::ComponentID sy::QueryComponentID<ComponentType>() \
+constexpr sy::ComponentHash sy::QueryComponentHash<ComponentType>() \
 {	\
-	constexpr uint32_t genID = COMPONENT_TYPE_HASH(ComponentType); \
-	static_assert(genID != 0 && "Generated Component ID is not valid."); \
-	return static_cast<sy::ComponentID>(genID);	\
-}\
+	constexpr sy::ComponentHash hash = COMPONENT_TYPE_HASH(ComponentType); \
+	static_assert(hash != sy::INVALID_COMPONENT_HASH && "Generated Component Hash is not valid."); \
+	return hash;	\
+}
 
-#define DefineComponent(ComponentType) ComponentType##Registeration ComponentType##Registeration::registeration;
\ No newline at end of file
+/** Enableable component must be declared before its first use, same as DeclareComponent. */
+#define DeclareEnableableComponent(ComponentType) \
+template <> \
+constexpr bool sy::IS_ENABLEABLE_COMPONENT<ComponentType> = true; \
+DeclareComponent(ComponentType)
+
+/** Tag component must be declared before its first use, same as DeclareComponent. */
+#define DeclareTagComponent(ComponentType) \
+template <> \
+constexpr bool sy::IS_TAG_COMPONENT<ComponentType> = true; \
+static_assert(std::is_empty_v<ComponentType> && "Tag component must be empty type."); \
+DeclareComponent(ComponentType)
+
+/** Shared component must be declared before its first use, same as DeclareComponent. */
+#define DeclareSharedComponent(ComponentType) \
+template <> \
+constexpr bool sy::IS_SHARED_COMPONENT<ComponentType> = true; \
+DeclareComponent(ComponentType)
+
+/** Declare fields of component as member pointers(e.g. &Component::Field), it must be placed before DeclareComponent of same component. */
+#define DeclareComponentFields(ComponentType, ...) \
+template <> \
+struct sy::ComponentFields<ComponentType> \
+{ \
+	static constexpr bool bIsDeclared = true; \
+	static constexpr auto Members = std::make_tuple(__VA_ARGS__); \
+};
@@ -4,6 +4,10 @@
 #include <array>
 #include <random>
 #include <chrono>
+#include <queue>
+#include <numeric>
+#include <algorithm>
+#include <latch>
 using namespace sy;
 
 #define _CRTDBG_MAP_ALLOC
@@ -18,76 +22,165 @@ struct Tag
 {
 };
 
-struct Visible : Component
+/** Counts objects of component type, objects which moved between rows are counted separately from default constructed objects. */
+template <typename T>
+struct LifetimeCounter
 {
-	Visible() noexcept
+	LifetimeCounter() noexcept
 	{
 		++Alloc;
 	}
 
-	virtual ~Visible()
+	LifetimeCounter(LifetimeCounter&&) noexcept
+	{
+		++Moved;
+	}
+
+	LifetimeCounter(const LifetimeCounter&) = delete;
+	LifetimeCounter& operator=(const LifetimeCounter&) = delete;
+	LifetimeCounter& operator=(LifetimeCounter&&) noexcept = default;
+
+	~LifetimeCounter()
 	{
 		++Dealloc;
 	}
 
+	inline static size_t Alloc = 0;
+	inline static size_t Moved = 0;
+	inline static size_t Dealloc = 0;
+};
+
+struct Visible : LifetimeCounter<Visible>
+{
 	double ClipDistance = 2022.0519;
 	float VisibleDistance = 1234.4321f;
 	uint64_t A = 400;
 	uint64_t B = 0xffffffff;
 	std::vector<std::tuple<int, int>> compund;
 
-	inline static size_t Alloc = 0;
-	inline static size_t Dealloc = 0;
 };
 
-struct Hittable : Component
+struct Hittable : LifetimeCounter<Hittable>
 {
-	Hittable() noexcept
-	{
-		++Alloc;
-	}
-
-	virtual ~Hittable()
-	{
-		++Dealloc;
-	}
-
 	float HitDistance = 1000.0f;
 	uint64_t HitCount = 3;
 	float t = 3.141592f;
 
-	inline static size_t Alloc = 0;
-	inline static size_t Dealloc = 0;
 };
 
-struct Invisible : Component
+struct Invisible : LifetimeCounter<Invisible>
 {
-	Invisible() noexcept
-	{
-		++Alloc;
-	}
+	uint64_t Duration = 186;
+
+};
+
+/** Bulky config which many entities share, stored once per chunk list. It still derives optional Component base. */
+struct LODConfig : Component
+{
+	uint32_t Level = 0;
+	std::array<float, 32> Distances = {};
 
-	virtual ~Invisible()
+	bool operator==(const LODConfig& rhs) const noexcept
 	{
-		++Dealloc;
+		return Level == rhs.Level && Distances == rhs.Distances;
 	}
+};
 
-	uint64_t Duration = 186;
+/** Same fields as Particle, but stored as array of whole objects. */
+struct WholeParticle
+{
+	float PositionX = 0.0f;
+	float PositionY = 0.0f;
+	float PositionZ = 0.0f;
+	float VelocityX = 1.0f;
+	float VelocityY = 1.0f;
+	float VelocityZ = 1.0f;
+	float Mass = 1.0f;
+	float Lifetime = 10.0f;
+	std::array<float, 6> Color = {};
+};
 
-	inline static size_t Alloc = 0;
-	inline static size_t Dealloc = 0;
+/** Plain data component, it is trivially copyable and has no vtable. */
+struct Velocity
+{
+	float X = 0.0f;
+	float Y = 0.0f;
+	float Z = 0.0f;
+};
+
+struct Particle
+{
+	float PositionX = 0.0f;
+	float PositionY = 0.0f;
+	float PositionZ = 0.0f;
+	float VelocityX = 1.0f;
+	float VelocityY = 1.0f;
+	float VelocityZ = 1.0f;
+	float Mass = 1.0f;
+	float Lifetime = 10.0f;
+	std::array<float, 6> Color = {};
 };
 
 DeclareComponent(Visible);
-DefineComponent(Visible);
 
 DeclareComponent(Hittable);
-DefineComponent(Hittable);
 
-DeclareComponent(Invisible);
-DefineComponent(Invisible);
+DeclareEnableableComponent(Invisible);
+
+DeclareTagComponent(Tag);
+
+DeclareComponent(Velocity);
+
+DeclareSharedComponent(LODConfig);
+
+DeclareComponent(WholeParticle);
+
+DeclareComponentFields(Particle,
+	&Particle::PositionX, &Particle::PositionY, &Particle::PositionZ,
+	&Particle::VelocityX, &Particle::VelocityY, &Particle::VelocityZ,
+	&Particle::Mass, &Particle::Lifetime, &Particle::Color);
+DeclareComponent(Particle);
 
 #define TEST_COUNT 1000000
+#define TEST_CHUNK_STORAGE_MODE ChunkStorageMode::Sparse
+
+/** Rows of disabled entities must be skipped by chunk iteration, and every other rows must be visited. */
+static bool ValidateEnabledInvisibles(ComponentArchive& componentArchive, const std::vector<Entity>& entities, const std::set<Entity>& disabledEntities)
+{
+	size_t numOfEnabledRows = 0;
+	size_t numOfDisabledRows = 0;
+	bool bIsValid = true;
+	componentArchive.ForEachChunk<Invisible>([&numOfEnabledRows, &numOfDisabledRows, &bIsValid, &disabledEntities](const ChunkView& chunkView)
+		{
+			const std::span<const Entity> chunkEntities = chunkView.Entities();
+			for (size_t row = 0; row < chunkEntities.size(); ++row)
+			{
+				if (chunkEntities[row] != INVALID_ENTITY_HANDLE)
+				{
+					const bool bIsEnabled = chunkView.IsEnabled(row);
+					bIsValid = bIsValid && (bIsEnabled != disabledEntities.contains(chunkEntities[row]));
+					numOfEnabledRows += bIsEnabled ? 1 : 0;
+					numOfDisabledRows += bIsEnabled ? 0 : 1;
+				}
+			}
+		});
+
+	size_t numOfEnabledEntities = 0;
+	size_t numOfDisabledEntities = 0;
+	for (const Entity entity : entities)
+	{
+		if (componentArchive.Contains<Invisible>(entity))
+		{
+			const bool bIsEnabled = componentArchive.IsEnabled<Invisible>(entity);
+			bIsValid = bIsValid && (bIsEnabled != disabledEntities.contains(entity));
+			numOfEnabledEntities += bIsEnabled ? 1 : 0;
+			numOfDisabledEntities += bIsEnabled ? 0 : 1;
+		}
+	}
+
+	/** Chunk iteration also visits entities which are not in given entities. (e.g. e0) */
+	return bIsValid && numOfDisabledRows == numOfDisabledEntities && numOfEnabledRows >= numOfEnabledEntities;
+}
 
 static std::chrono::milliseconds LinearDataValidation(const ComponentArchive& componentArchive, const std::vector<Entity> entities, const Visible& referenceVisible, const Hittable& referenceHittable, const Invisible& referenceInvisible)
 {
@@ -216,12 +309,225 @@ static std::chrono::milliseconds RandomDataValidation(const ComponentArchive& co
 	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
 }
 
-int main()
+/** Average latency of random Get, bChecksSignature reproduces signature check which Get did before column lookup answers it. */
+static double RandomGetLatency(const ComponentArchive& componentArchive, const std::vector<Entity>& entities, const bool bChecksSignature)
+{
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<size_t> accessDist(0, entities.size() - 1);
+	std::vector<Entity> accessOrder(TEST_COUNT);
+	std::generate(accessOrder.begin(), accessOrder.end(), [&]() { return entities[accessDist(gen)]; });
+
+	uint64_t checksum = 0;
+	const auto begin = std::chrono::steady_clock::now();
+	for (const Entity entity : accessOrder)
+	{
+		const Hittable* hittable = (!bChecksSignature || componentArchive.Contains<Hittable>(entity)) ? componentArchive.Get<Hittable>(entity) : nullptr;
+		if (hittable != nullptr)
+		{
+			checksum += hittable->HitCount;
+		}
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+	volatile uint64_t sink = checksum;
+	(void)sink;
+	return static_cast<double>(elapsed.count()) / accessOrder.size();
+}
+
+/** Slot pool which Chunk used before occupancy bitmask. Only exist for benchmark comparison. */
+class PriorityQueueSlotPool
+{
+public:
+	PriorityQueueSlotPool(const size_t maxNumOfAllocations)
+	{
+		for (size_t allocationIndex = 0; allocationIndex < maxNumOfAllocations; ++allocationIndex)
+		{
+			pool.push(allocationIndex);
+		}
+	}
+
+	size_t Allocate()
+	{
+		const size_t alloc = pool.top();
+		pool.pop();
+		return alloc;
+	}
+
+	void Deallocate(const size_t at)
+	{
+		pool.push(at);
+	}
+
+	[[nodiscard]] bool IsFull() const noexcept { return pool.empty(); }
+
+private:
+	std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> pool;
+};
+
+/** Fill slot pool up and then repeatedly release batch of random slots and allocate them again. Return checksum of allocated slot indices through out parameter. */
+template <typename SlotPool>
+static std::chrono::milliseconds SlotChurn(SlotPool& pool, const std::vector<size_t>& releaseSequence, const size_t maxNumOfAllocations, const size_t churnBatchSize, size_t& checksum)
+{
+	std::vector<size_t> liveAllocations;
+	liveAllocations.reserve(maxNumOfAllocations);
+
+	checksum = 0;
+	const auto begin = std::chrono::steady_clock::now();
+	while (!pool.IsFull())
+	{
+		liveAllocations.emplace_back(pool.Allocate());
+	}
+
+	for (size_t batchBegin = 0; (batchBegin + churnBatchSize) <= releaseSequence.size(); batchBegin += churnBatchSize)
+	{
+		/** Release sequence never contains duplicated index in same batch. */
+		for (size_t idx = batchBegin; idx < (batchBegin + churnBatchSize); ++idx)
+		{
+			pool.Deallocate(liveAllocations[releaseSequence[idx]]);
+		}
+
+		for (size_t idx = batchBegin; idx < (batchBegin + churnBatchSize); ++idx)
+		{
+			liveAllocations[releaseSequence[idx]] = pool.Allocate();
+			checksum += liveAllocations[releaseSequence[idx]];
+		}
+	}
+
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+}
+
+/** Check columns are aligned, never overlap, fit in chunk and chunk can not hold one more row. */
+static bool ValidateChunkLayout(const std::vector<ComponentInfo>& componentInfos, const size_t chunkSize)
+{
+	const ChunkList::Layout layout = ChunkList::ComputeLayout(componentInfos, chunkSize);
+	const size_t numOfRows = layout.MaxNumOfAllocations;
+	bool bIsValid = layout.ComponentAllocInfos.size() == componentInfos.size();
+
+	size_t sizeOfRow = 0;
+	for (const ComponentInfo& info : componentInfos)
+	{
+		sizeOfRow += info.Size;
+		const auto allocInfo = std::find_if(layout.ComponentAllocInfos.cbegin(), layout.ComponentAllocInfos.cend(), [&info](const ChunkList::ComponentAllocationInfo& allocInfo)
+			{
+				return allocInfo.ID == info.ID;
+			});
+
+		bIsValid = bIsValid && allocInfo != layout.ComponentAllocInfos.cend();
+		bIsValid = bIsValid && (allocInfo->Range.Offset % info.Alignment) == 0;
+		bIsValid = bIsValid && (allocInfo->Range.Offset + (allocInfo->Range.Size * numOfRows)) <= chunkSize;
+	}
+
+	for (size_t lhs = 0; lhs < layout.ComponentAllocInfos.size(); ++lhs)
+	{
+		for (size_t rhs = lhs + 1; rhs < layout.ComponentAllocInfos.size(); ++rhs)
+		{
+			const ComponentRange lhsRange = layout.ComponentAllocInfos[lhs].Range;
+			const ComponentRange rhsRange = layout.ComponentAllocInfos[rhs].Range;
+			const bool bIsOverlapped =
+				lhsRange.Offset < (rhsRange.Offset + (rhsRange.Size * numOfRows)) &&
+				rhsRange.Offset < (lhsRange.Offset + (lhsRange.Size * numOfRows));
+			bIsValid = bIsValid && !bIsOverlapped;
+		}
+	}
+
+	/** Size of component is always multiple of its alignment, so one more row never fits in tightly packed layout. */
+	const bool bIsMaximal = numOfRows == Chunk::MAX_NUM_OF_ALLOCATIONS || (sizeOfRow * (numOfRows + 1)) > chunkSize;
+	return bIsValid && bIsMaximal;
+}
+
+/** Every chunk of dense chunk list must be contiguous, and each entities must be found at its own allocation. */
+static bool ValidateDenseChunkList(const ChunkList& chunkList, const std::vector<ChunkList::Allocation>& allocations, const ComponentID validationComponentID)
+{
+	bool bIsValid = true;
+	size_t numOfEntities = 0;
+	for (size_t chunkIndex = 0; chunkIndex < chunkList.NumOfChunks(); ++chunkIndex)
+	{
+		const std::span<const Entity> entities = chunkList.EntitiesOf(chunkIndex);
+		const auto* column = static_cast<const uint64_t*>(chunkList.ColumnOf(chunkIndex, validationComponentID));
+		for (size_t allocationIndex = 0; allocationIndex < entities.size(); ++allocationIndex)
+		{
+			const Entity entity = entities[allocationIndex];
+			const auto entityIndex = static_cast<size_t>(entity);
+			bIsValid = bIsValid && entity != INVALID_ENTITY_HANDLE;
+			bIsValid = bIsValid && allocations[entityIndex].ChunkIndex == chunkIndex && allocations[entityIndex].AllocationIndexOfEntity == allocationIndex;
+			bIsValid = bIsValid && column[allocationIndex] == ~static_cast<uint64_t>(entity);
+			++numOfEntities;
+		}
+	}
+
+	return bIsValid && numOfEntities == static_cast<size_t>(std::ranges::count_if(allocations, [](const ChunkList::Allocation allocation) { return !allocation.IsFailedToAllocate(); }));
+}
+
+struct RowSizeIterationResult
+{
+	size_t ChunkSize = 0;
+	size_t MaxNumOfAllocationsPerChunk = 0;
+	size_t NumOfChunks = 0;
+	std::chrono::milliseconds CreateElapsedTime;
+	std::chrono::microseconds IterateElapsedTime;
+};
+
+/** Create rows of chunk list until it reach to fixed amount of data, then read every cache lines of each rows. */
+static RowSizeIterationResult RowSizeIteration(ChunkAllocator& chunkAllocator, const std::vector<ComponentInfo>& rowComponentInfos, const size_t forcedChunkSize)
 {
-	constexpr ComponentID visibeID = QueryComponentID<Visible>();
-	constexpr ComponentID hittableID = QueryComponentID<Hittable>();
-	constexpr ComponentID invisibleID = QueryComponentID<Invisible>();
+	constexpr size_t rowSizeTestDataSize = 64 * 1024 * 1024;
+	size_t sizeOfRow = 0;
+	for (const ComponentInfo& info : rowComponentInfos)
+	{
+		sizeOfRow += info.Size;
+	}
+
+	ChunkList chunkList(chunkAllocator, rowComponentInfos, ChunkStorageMode::Sparse, forcedChunkSize);
+	const size_t numOfRows = rowSizeTestDataSize / sizeOfRow;
+	std::vector<ChunkList::Allocation> allocations;
+	allocations.reserve(numOfRows);
+
+	auto begin = std::chrono::steady_clock::now();
+	for (size_t row = 0; row < numOfRows; ++row)
+	{
+		const ChunkList::Allocation allocation = chunkList.Create(static_cast<Entity>(row + 1));
+		for (const ComponentInfo& info : rowComponentInfos)
+		{
+			std::memset(chunkList.AddressOf(allocation, info.ID), static_cast<int>(row), info.Size);
+		}
+
+		allocations.emplace_back(allocation);
+	}
+	const auto createElapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+
+	uint64_t checksum = 0;
+	begin = std::chrono::steady_clock::now();
+	for (const ChunkList::Allocation allocation : allocations)
+	{
+		for (const ComponentInfo& info : rowComponentInfos)
+		{
+			const auto* column = static_cast<const uint8_t*>(chunkList.AddressOf(allocation, info.ID));
+			for (size_t offset = 0; offset < info.Size; offset += CACHE_LINE)
+			{
+				checksum += column[offset];
+			}
+		}
+	}
+	const auto iterateElapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+	assert(checksum > 0 || numOfRows <= 1);
+
+	const RowSizeIterationResult result{
+		.ChunkSize = chunkList.ChunkSize(),
+		.MaxNumOfAllocationsPerChunk = chunkList.MaxNumOfAllocationsPerChunk(),
+		.NumOfChunks = chunkList.NumOfChunks(),
+		.CreateElapsedTime = createElapsedTime,
+		.IterateElapsedTime = iterateElapsedTime };
+
+	for (const ChunkList::Allocation allocation : allocations)
+	{
+		chunkList.Destroy(allocation);
+	}
 
+	return result;
+}
+
+int main()
+{
 	const std::string red = "\033[1;31m";
 	const std::string green = "\033[1;32m";
 	const std::string yellow = "\033[1;33m";
@@ -232,14 +538,262 @@ int main()
 	size_t invisibleAllocCount = 0;
 
 	std::this_thread::sleep_for(std::chrono::seconds(2));
+	{
+		/******************************************************************/
+		/* Chunk slot allocator benchmark (priority_queue vs occupancy bitmask) */
+		std::cout << yellow << "* Chunk Slot Allocator Benchmark" << reset << std::endl;
+		constexpr size_t slotChurnCapacity = 1024;
+		constexpr size_t slotChurnBatchSize = 256;
+		constexpr size_t numOfSlotChurns = TEST_COUNT * 4;
+
+		std::vector<size_t> releaseSequence;
+		releaseSequence.reserve(numOfSlotChurns);
+		{
+			std::mt19937 slotGen(20220519);
+			std::vector<size_t> slotIndices(slotChurnCapacity);
+			std::iota(slotIndices.begin(), slotIndices.end(), 0);
+			while (releaseSequence.size() < numOfSlotChurns)
+			{
+				std::shuffle(slotIndices.begin(), slotIndices.end(), slotGen);
+				releaseSequence.insert(releaseSequence.end(), slotIndices.begin(), slotIndices.begin() + slotChurnBatchSize);
+			}
+		}
+
+		size_t queueChecksum = 0;
+		PriorityQueueSlotPool queuePool(slotChurnCapacity);
+		const auto queueElapsedTime = SlotChurn(queuePool, releaseSequence, slotChurnCapacity, slotChurnBatchSize, queueChecksum);
+		std::cout << "** priority_queue slot pool churn takes " << green << queueElapsedTime.count() << reset << " ms" << std::endl;
+
+		size_t chunkChecksum = 0;
+		ChunkAllocator slotChurnChunkAllocator;
+		Chunk chunk(slotChurnChunkAllocator, DEFAULT_CHUNK_SIZE, slotChurnCapacity);
+		const auto chunkElapsedTime = SlotChurn(chunk, releaseSequence, slotChurnCapacity, slotChurnBatchSize, chunkChecksum);
+		std::cout << "** Chunk occupancy bitmask churn takes " << green << chunkElapsedTime.count() << reset << " ms" << std::endl;
+
+		/* Both of pool must hand out lowest free slot first. */
+		assert(queueChecksum == chunkChecksum);
+		std::cout << "** Lowest slot first order matches : " << (queueChecksum == chunkChecksum ? green + "True" : red + "False") << reset << std::endl << std::endl << std::endl;
+	}
+
+	{
+		/******************************************************************/
+		/* Chunk allocator benchmark (aligned malloc per chunk vs recycling chunk allocator) */
+		std::cout << yellow << "* Chunk Allocator Benchmark" << reset << std::endl;
+		constexpr size_t numOfSpikeChunks = 4096;
+		constexpr size_t numOfSpikes = 64;
+		std::vector<void*> spikeChunks(numOfSpikeChunks, nullptr);
+
+		auto begin = std::chrono::steady_clock::now();
+		for (size_t spike = 0; spike < numOfSpikes; ++spike)
+		{
+			for (void*& spikeChunk : spikeChunks)
+			{
+				spikeChunk = _aligned_malloc(DEFAULT_CHUNK_SIZE, CACHE_LINE);
+				std::memset(spikeChunk, 0, CACHE_LINE);
+			}
+
+			for (void* spikeChunk : spikeChunks)
+			{
+				_aligned_free(spikeChunk);
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "** Aligned malloc spike & shrink takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		ChunkAllocator spikeChunkAllocator(numOfSpikeChunks * DEFAULT_CHUNK_SIZE);
+		begin = std::chrono::steady_clock::now();
+		for (size_t spike = 0; spike < numOfSpikes; ++spike)
+		{
+			for (void*& spikeChunk : spikeChunks)
+			{
+				spikeChunk = spikeChunkAllocator.Allocate(DEFAULT_CHUNK_SIZE);
+				std::memset(spikeChunk, 0, CACHE_LINE);
+			}
+
+			for (void* spikeChunk : spikeChunks)
+			{
+				spikeChunkAllocator.Deallocate(spikeChunk, DEFAULT_CHUNK_SIZE);
+			}
+
+			spikeChunkAllocator.Trim();
+		}
+		end = std::chrono::steady_clock::now();
+		const auto spikeStatistics = spikeChunkAllocator.QueryStatistics();
+		std::cout << "** Chunk allocator spike & shrink takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+		std::cout << "** Chunk allocator hits/misses : " << green << spikeStatistics.Hits << reset << " / " << red << spikeStatistics.Misses << reset << std::endl;
+		assert(spikeStatistics.Misses == numOfSpikeChunks);
+		std::cout << std::endl << std::endl;
+	}
+
+	{
+		/******************************************************************/
+		/* Chunk layout tests for every combination of component sizes and alignments */
+		std::cout << yellow << "* Chunk Layout Tests" << reset << std::endl;
+		std::vector<ComponentInfo> layoutComponentInfos;
+		for (size_t alignment = 1; alignment <= 128; alignment *= 2)
+		{
+			for (const size_t sizeMultiplier : { 1, 3, 8 })
+			{
+				layoutComponentInfos.emplace_back(ComponentInfo{
+					.ID = static_cast<ComponentID>(layoutComponentInfos.size() + 1),
+					.Name = "Layout",
+					.Size = alignment * sizeMultiplier,
+					.Alignment = alignment,
+					.Fields = {} });
+			}
+		}
+
+		size_t numOfLayouts = 0;
+		size_t numOfInvalidLayouts = 0;
+		for (const size_t chunkSize : CHUNK_SIZE_CLASSES)
+		{
+			for (size_t first = 0; first < layoutComponentInfos.size(); ++first)
+			{
+				for (size_t second = first + 1; second < layoutComponentInfos.size(); ++second)
+				{
+					for (size_t third = second + 1; third <= layoutComponentInfos.size(); ++third)
+					{
+						/** Third index at end of infos means archetype which has only two components. */
+						std::vector<ComponentInfo> archetypeComponentInfos = { layoutComponentInfos[first], layoutComponentInfos[second] };
+						if (third < layoutComponentInfos.size())
+						{
+							archetypeComponentInfos.emplace_back(layoutComponentInfos[third]);
+						}
+
+						++numOfLayouts;
+						if (!ValidateChunkLayout(archetypeComponentInfos, chunkSize))
+						{
+							++numOfInvalidLayouts;
+						}
+					}
+				}
+			}
+		}
+
+		assert(numOfInvalidLayouts == 0);
+		std::cout << "** Validated layouts : " << green << numOfLayouts << reset << ", Invalid layouts : " << (numOfInvalidLayouts == 0 ? green : red) << numOfInvalidLayouts << reset << std::endl;
+
+		struct alignas(32) SIMDVector
+		{
+			float Elements[8];
+		};
+
+		const ComponentID simdID = QueryComponentID<Invisible>() + 1;
+		const ChunkList::Layout overAlignedLayout = ChunkList::ComputeLayout({
+			ComponentInfo::Generate<Invisible>(),
+			ComponentInfo{ .ID = simdID, .Name = "SIMDVector", .Size = sizeof(SIMDVector), .Alignment = alignof(SIMDVector), .Fields = {} } }, DEFAULT_CHUNK_SIZE);
+		bool bFoundSIMDColumn = false;
+		for (const ChunkList::ComponentAllocationInfo& allocInfo : overAlignedLayout.ComponentAllocInfos)
+		{
+			if (allocInfo.ID == simdID)
+			{
+				bFoundSIMDColumn = true;
+				assert((allocInfo.Range.Offset % alignof(SIMDVector)) == 0);
+			}
+		}
+		assert(bFoundSIMDColumn);
+
+		const ChunkList::Layout archetypeLayout = ChunkList::ComputeLayout({
+			ComponentInfo::Generate<Visible>(),
+			ComponentInfo::Generate<Hittable>(),
+			ComponentInfo::Generate<Invisible>() }, DEFAULT_CHUNK_SIZE);
+		std::cout << "** Visible-Hittable-Invisible rows per 16 KB chunk : " << green << archetypeLayout.MaxNumOfAllocations << reset << std::endl;
+		std::cout << std::endl << std::endl;
+	}
+
+	{
+		/******************************************************************/
+		/* Dense chunk storage tests (swap-and-pop destroy keeps every chunks contiguous) */
+		std::cout << yellow << "* Dense Chunk Storage Tests" << reset << std::endl;
+		constexpr size_t numOfDenseEntities = TEST_COUNT / 10;
+		const std::vector<ComponentInfo> denseComponentInfos = {
+			ComponentInfo{ .ID = 1, .Name = "Validation", .Size = sizeof(uint64_t), .Alignment = alignof(uint64_t), .Fields = {} },
+			ComponentInfo{ .ID = 2, .Name = "Payload", .Size = 24, .Alignment = alignof(uint64_t), .Fields = {} } };
+
+		ChunkAllocator denseChunkAllocator;
+		ChunkList denseChunkList(denseChunkAllocator, denseComponentInfos, ChunkStorageMode::Dense);
+		/** Entity handle is index of allocations, 0 is invalid handle. */
+		std::vector<ChunkList::Allocation> denseAllocations(numOfDenseEntities + 1);
+		for (size_t entityIndex = 1; entityIndex <= numOfDenseEntities; ++entityIndex)
+		{
+			const auto entity = static_cast<Entity>(entityIndex);
+			denseAllocations[entityIndex] = denseChunkList.Create(entity);
+			*static_cast<uint64_t*>(denseChunkList.AddressOf(denseAllocations[entityIndex], 1)) = ~static_cast<uint64_t>(entity);
+		}
+
+		std::mt19937 denseGen(20220519);
+		std::uniform_int_distribution<size_t> denseDist(1, numOfDenseEntities);
+		size_t numOfMovedEntities = 0;
+		const auto begin = std::chrono::steady_clock::now();
+		for (size_t count = 0; count < (numOfDenseEntities / 2); ++count)
+		{
+			const size_t entityIndex = denseDist(denseGen);
+			if (!denseAllocations[entityIndex].IsFailedToAllocate())
+			{
+				const Entity movedEntity = denseChunkList.Destroy(denseAllocations[entityIndex]);
+				if (movedEntity != INVALID_ENTITY_HANDLE)
+				{
+					denseAllocations[static_cast<size_t>(movedEntity)] = denseAllocations[entityIndex];
+					++numOfMovedEntities;
+				}
+
+				denseAllocations[entityIndex] = ChunkList::Allocation();
+			}
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		const bool bIsDenseChunkListValid = ValidateDenseChunkList(denseChunkList, denseAllocations, 1);
+		assert(bIsDenseChunkListValid);
+		std::cout << "** Random destroy takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms, moved entities -> " << green << numOfMovedEntities << reset << std::endl;
+		std::cout << "** Chunks are contiguous and entity column is consistent : " << (bIsDenseChunkListValid ? green + "True" : red + "False") << reset << std::endl;
+		std::cout << std::endl << std::endl;
+	}
+
+	{
+		/******************************************************************/
+		/* Chunk size class benchmark across row sizes (fixed 16 KB chunk vs chunk size classes) */
+		std::cout << yellow << "* Chunk Size Class Benchmark" << reset << std::endl;
+		ChunkAllocator rowSizeChunkAllocator;
+		const auto printRowSizeIteration = [&green, &reset](const std::string& label, const RowSizeIterationResult& result)
+		{
+			std::cout << "*** " << label << " : " << green << (result.ChunkSize / 1024) << reset << " KB chunk, "
+				<< green << result.MaxNumOfAllocationsPerChunk << reset << " rows per chunk, "
+				<< green << result.NumOfChunks << reset << " chunks, create takes "
+				<< green << result.CreateElapsedTime.count() << reset << " ms, iteration takes "
+				<< green << result.IterateElapsedTime.count() << reset << " us" << std::endl;
+		};
+
+		for (const size_t sizeOfRow : { 64, 512, 2048, 8192, 65536, 524288 })
+		{
+			/** Row is split into two columns, to make sure column offsets are also valid in every chunk sizes. */
+			const std::vector<ComponentInfo> rowComponentInfos = {
+				ComponentInfo{ .ID = 1, .Name = "RowHead", .Size = sizeOfRow / 2, .Alignment = alignof(uint64_t), .Fields = {} },
+				ComponentInfo{ .ID = 2, .Name = "RowTail", .Size = sizeOfRow / 2, .Alignment = alignof(uint64_t), .Fields = {} } };
+
+			std::cout << "** Row size " << sizeOfRow << " bytes" << std::endl;
+			if (ChunkList(rowSizeChunkAllocator, rowComponentInfos, ChunkStorageMode::Sparse, DEFAULT_CHUNK_SIZE).MaxNumOfAllocationsPerChunk() > 0)
+			{
+				printRowSizeIteration("Fixed 16 KB chunk", RowSizeIteration(rowSizeChunkAllocator, rowComponentInfos, DEFAULT_CHUNK_SIZE));
+			}
+			else
+			{
+				std::cout << "*** Fixed 16 KB chunk : " << red << "Can not hold single row" << reset << std::endl;
+			}
+
+			printRowSizeIteration("Chunk size class", RowSizeIteration(rowSizeChunkAllocator, rowComponentInfos, 0));
+		}
+		std::cout << std::endl << std::endl;
+	}
+
 	{
 		auto& componentArchive = ComponentArchive::Instance();
+		componentArchive.SetChunkStorageMode(TEST_CHUNK_STORAGE_MODE);
 		/******************************************************************/
 		/* Test API basis by manually */
 		const Entity e0 = GenerateEntity();
 		bool result = componentArchive.Attach<Visible>(e0);
 		assert(result);
-		Visible* visible = componentArchive.Get<Visible>(e0);
+		Visible* visible = componentArchive.GetMut<Visible>(e0);
 		const auto visibleHandle = componentArchive.GetHandle<Visible>(e0);
 		assert(visible != nullptr);
 		assert(visible == componentArchive.Get<Visible>(e0));
@@ -249,7 +803,7 @@ int main()
 		// 'visible' pointer will be expired at here
 		result = componentArchive.Attach<Hittable>(e0);
 		assert(result);
-		Hittable* hittable = componentArchive.Get<Hittable>(e0);
+		Hittable* hittable = componentArchive.GetMut<Hittable>(e0);
 		assert(hittable != nullptr);
 		assert(hittable == componentArchive.Get<Hittable>(e0));
 		assert(!componentArchive.Attach<Visible>(e0));
@@ -261,7 +815,7 @@ int main()
 		Hittable referenceHittable;
 		++visibleAllocCount;
 		++hittableAllocCount;
-		visible = componentArchive.Get<Visible>(e0);
+		visible = componentArchive.GetMut<Visible>(e0);
 		assert(visible != nullptr);
 		assert(visible->A == referenceVisible.A);
 		assert(visible->B == referenceVisible.B);
@@ -283,7 +837,7 @@ int main()
 		// 'visible' pointer and 'hittable' pointer will be expired at here 
 		result = componentArchive.Attach<Invisible>(e0);
 		assert(result);
-		Invisible* invisible = componentArchive.Get<Invisible>(e0);
+		Invisible* invisible = componentArchive.GetMut<Invisible>(e0);
 		++invisibleAllocCount;
 		assert(invisible != nullptr);
 		assert(invisible == componentArchive.Get<Invisible>(e0));
@@ -294,8 +848,8 @@ int main()
 		// Check validation of component value #2
 		Invisible referenceInvisible;
 		++invisibleAllocCount;
-		visible = componentArchive.Get<Visible>(e0);
-		hittable = componentArchive.Get<Hittable>(e0);
+		visible = componentArchive.GetMut<Visible>(e0);
+		hittable = componentArchive.GetMut<Hittable>(e0);
 		assert(visible != nullptr);
 		assert(hittable != nullptr);
 		assert(visible->A == referenceVisible.A);
@@ -308,9 +862,9 @@ int main()
 		assert(invisible->Duration == referenceInvisible.Duration);
 
 		componentArchive.Detach<Visible>(e0);
-		hittable = componentArchive.Get<Hittable>(e0);
-		invisible = componentArchive.Get<Invisible>(e0);
-		visible = componentArchive.Get<Visible>(e0);
+		hittable = componentArchive.GetMut<Hittable>(e0);
+		invisible = componentArchive.GetMut<Invisible>(e0);
+		visible = componentArchive.GetMut<Visible>(e0);
 		assert(!visibleHandle.IsValid()); /** Visible Handle is no longer valid. */
 		assert(visible == nullptr);
 		assert(hittable != nullptr);
@@ -346,7 +900,7 @@ int main()
 		{
 			if (componentArchive.Attach<Visible>(entity))
 			{
-				Visible* visible = componentArchive.Get<Visible>(entity);
+				Visible* visible = componentArchive.GetMut<Visible>(entity);
 				if (visible != nullptr)
 				{
 					visible->A = count + 0xffffff;
@@ -365,7 +919,7 @@ int main()
 		{
 			if (componentArchive.Attach<Hittable>(entity))
 			{
-				Hittable* hittable = componentArchive.Get<Hittable>(entity);
+				Hittable* hittable = componentArchive.GetMut<Hittable>(entity);
 				if (hittable != nullptr)
 				{
 					++hittableAllocCount;
@@ -468,6 +1022,8 @@ int main()
 
 		elapsedTime = RandomDataValidation(componentArchive, entities, referenceVisible, referenceHittable, referenceInvisible);
 		std::cout << "** Random Generation - Random Access & Validation takes " << green << elapsedTime.count() << reset << " ms" << std::endl;
+		std::cout << "** Random Get with signature check : " << green << RandomGetLatency(componentArchive, entities, true) << reset << " ns/Get" << std::endl;
+		std::cout << "** Random Get through column lookup : " << green << RandomGetLatency(componentArchive, entities, false) << reset << " ns/Get" << std::endl;
 
 		/******************************************************************/
 		/* Filtering Methods (All, Any, None) tests */
@@ -514,6 +1070,129 @@ int main()
 		}
 		std::cout << "** All Filtering tests takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
 
+		/******************************************************************/
+		/* Change version tests (visit only chunks which written after given version) */
+		std::cout << std::endl << std::endl << yellow << "* Change Filter Tests" << reset << std::endl;
+		const uint64_t lastVersion = componentArchive.AdvanceVersion();
+		/** Plain Get and Column only read, so they never stamp version even through non-const archive and view. */
+		size_t numOfReadVisibles = 0;
+		for (size_t idx = 0; idx < entities.size(); idx += 13)
+		{
+			numOfReadVisibles += componentArchive.Get<Visible>(entities[idx]) != nullptr ? 1 : 0;
+		}
+		componentArchive.ForEachChunk<Visible>([](ChunkView& chunkView) { [[maybe_unused]] const Visible* visibles = chunkView.Column<Visible>(); });
+
+		size_t numOfUnchangedChunks = 0;
+		componentArchive.ForEachChunk<Visible>([&numOfUnchangedChunks](const ChunkView&) { ++numOfUnchangedChunks; }, lastVersion);
+		assert(numOfReadVisibles > 0 && numOfUnchangedChunks == 0);
+
+		/** Only few percent of entities are written, as like as usual frame. */
+		std::vector<Entity> changedEntities;
+		for (size_t idx = 0; idx < (entities.size() / 20); idx += 7)
+		{
+			if (componentArchive.Contains<Visible>(entities[idx]))
+			{
+				componentArchive.GetMut<Visible>(entities[idx])->VisibleDistance = referenceVisible.VisibleDistance;
+				changedEntities.emplace_back(entities[idx]);
+			}
+		}
+
+		size_t numOfVisitedChunks = 0;
+		double visibleDistanceSum = 0.0;
+		const auto sumVisibleDistances = [&numOfVisitedChunks, &visibleDistanceSum](const ChunkView& chunkView)
+		{
+			const Visible* visibles = chunkView.Column<Visible>();
+			const std::span<const Entity> chunkEntities = chunkView.Entities();
+			for (size_t row = 0; row < chunkEntities.size(); ++row)
+			{
+				visibleDistanceSum += chunkEntities[row] != INVALID_ENTITY_HANDLE ? visibles[row].VisibleDistance : 0.0;
+			}
+			++numOfVisitedChunks;
+		};
+
+		begin = std::chrono::steady_clock::now();
+		componentArchive.ForEachChunk<Visible>(sumVisibleDistances);
+		end = std::chrono::steady_clock::now();
+		const size_t numOfVisibleChunks = std::exchange(numOfVisitedChunks, 0);
+		std::cout << "** Every Visible chunks iteration takes " << green << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << reset << " us, chunks -> " << numOfVisibleChunks << std::endl;
+
+		begin = std::chrono::steady_clock::now();
+		componentArchive.ForEachChunk<Visible>(sumVisibleDistances, lastVersion);
+		end = std::chrono::steady_clock::now();
+		const size_t numOfChangedChunks = numOfVisitedChunks;
+		std::cout << "** Changed Visible chunks iteration takes " << green << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << reset << " us, chunks -> " << numOfChangedChunks << std::endl;
+
+		std::set<Entity> entitiesOfChangedChunks;
+		componentArchive.ForEachChunk<Visible>([&entitiesOfChangedChunks](const ChunkView& chunkView)
+			{
+				entitiesOfChangedChunks.insert(chunkView.Entities().begin(), chunkView.Entities().end());
+			}, lastVersion);
+
+		const bool bAreChangesVisited = std::ranges::all_of(changedEntities, [&entitiesOfChangedChunks](const Entity entity) { return entitiesOfChangedChunks.contains(entity); });
+		assert(bAreChangesVisited);
+		assert(numOfChangedChunks <= numOfVisibleChunks);
+
+		size_t numOfChangedHittableChunks = 0;
+		componentArchive.ForEachChunk<Hittable>([&numOfChangedHittableChunks](const ChunkView&) { ++numOfChangedHittableChunks; }, lastVersion);
+		assert(numOfChangedHittableChunks == 0);
+		std::cout << "** Every written entities are in changed chunks, untouched columns are skipped : " << ((bAreChangesVisited && numOfChangedHittableChunks == 0) ? green + "True" : red + "False") << reset << std::endl;
+
+		/******************************************************************/
+		/* Enableable component tests (toggle without archetype migration) */
+		std::cout << std::endl << std::endl << yellow << "* Enableable Component Tests" << reset << std::endl;
+		std::vector<Entity> toggledEntities;
+		for (const Entity entity : entities)
+		{
+			if (toggledEntities.size() < (TEST_COUNT / 100) && componentArchive.Contains<Invisible>(entity))
+			{
+				toggledEntities.emplace_back(entity);
+			}
+		}
+
+		constexpr size_t numOfToggleRounds = 10;
+		begin = std::chrono::steady_clock::now();
+		for (size_t round = 0; round < numOfToggleRounds; ++round)
+		{
+			for (const Entity entity : toggledEntities)
+			{
+				componentArchive.Detach<Invisible>(entity);
+				componentArchive.Attach<Invisible>(entity);
+				++invisibleAllocCount;
+			}
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "** Detach & Attach toggle takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		begin = std::chrono::steady_clock::now();
+		for (size_t round = 0; round < numOfToggleRounds; ++round)
+		{
+			for (const Entity entity : toggledEntities)
+			{
+				componentArchive.Disable<Invisible>(entity);
+				componentArchive.Enable<Invisible>(entity);
+			}
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "** Disable & Enable toggle takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		/** Keep half of them disabled until end of tests, to check enabled state survives destroy and defragmentation. */
+		std::set<Entity> disabledEntities;
+		for (size_t idx = 0; idx < toggledEntities.size(); idx += 2)
+		{
+			const bool bIsDisabled = componentArchive.Disable<Invisible>(toggledEntities[idx]);
+			assert(bIsDisabled);
+			disabledEntities.insert(toggledEntities[idx]);
+		}
+
+		const std::vector<Entity> disabledEntityList(disabledEntities.cbegin(), disabledEntities.cend());
+		assert(Filter::All<Invisible>(componentArchive, disabledEntityList).empty());
+		assert(Filter::Any<Invisible>(componentArchive, disabledEntityList).empty());
+		assert(Filter::None<Invisible>(componentArchive, disabledEntityList).size() == disabledEntityList.size());
+		assert(!componentArchive.Disable<Invisible>(INVALID_ENTITY_HANDLE));
+		bool bIsEnabledStateValid = ValidateEnabledInvisibles(componentArchive, entities, disabledEntities);
+		assert(bIsEnabledStateValid);
+		std::cout << "** Queries and filters skip disabled components : " << (bIsEnabledStateValid ? green + "True" : red + "False") << reset << std::endl;
+
 		/******************************************************************/
 		/* Random Destroy Tests */
 		std::cout << std::endl << std::endl << yellow << "* Random Entity Destroy Tests" << reset << std::endl;
@@ -545,12 +1224,16 @@ int main()
 		/******************************************************************/
 		/* Defragmentation Tests */
 		std::cout << std::endl << std::endl << yellow << "* Defragmentation & ShrinkToFit Tests" << reset << std::endl;
+		const size_t numOfMaintenanceWorkers = std::max(std::thread::hardware_concurrency(), 1u);
 		begin = std::chrono::steady_clock::now();
-		const auto reduced = componentArchive.ShrinkToFit();
+		const auto reduced = componentArchive.ShrinkToFit(true, numOfMaintenanceWorkers);
 		end = std::chrono::steady_clock::now();
-		std::cout << "** Defragmentation & ShrinkToFit takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+		std::cout << "** Defragmentation & ShrinkToFit takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms (" << numOfMaintenanceWorkers << " workers)" << std::endl;
 		std::cout << "** Reduced Chunks -> " << red << reduced << reset << std::endl;
 		std::cout << "** Freed up Chunks Memory (estimation) -> " << green << ((reduced*16)/1024.0) << reset << " MB" << std::endl;
+		const auto chunkAllocatorStatistics = componentArchive.ReferenceChunkAllocator().QueryStatistics();
+		std::cout << "** Chunk allocator hits/misses : " << green << chunkAllocatorStatistics.Hits << reset << " / " << red << chunkAllocatorStatistics.Misses << reset << std::endl;
+		std::cout << "** Chunk allocator retained chunks : " << green << chunkAllocatorStatistics.NumOfRetainedChunks << reset << " (" << chunkAllocatorStatistics.NumOfSlabs << " slabs)" << std::endl;
 
 		/** Check data validation after defragmentation */
 		elapsedTime = LinearDataValidation(componentArchive, entities, referenceVisible, referenceHittable, referenceInvisible);
@@ -558,27 +1241,613 @@ int main()
 
 		elapsedTime = RandomDataValidation(componentArchive, entities, referenceVisible, referenceHittable, referenceInvisible);
 		std::cout << "** Defragmentation - Random Access & Validation takes " << green << elapsedTime.count() << reset << " ms" << std::endl;
+
+		std::erase_if(disabledEntities, [&componentArchive](const Entity entity) { return !componentArchive.Contains<Invisible>(entity); });
+		bIsEnabledStateValid = ValidateEnabledInvisibles(componentArchive, entities, disabledEntities);
+		assert(bIsEnabledStateValid);
+		std::cout << "** Enabled state survives destroy and defragmentation : " << (bIsEnabledStateValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/******************************************************************/
+		/* Incremental defragmentation tests (compaction is spread across multiple budgeted steps) */
+		std::cout << std::endl << std::endl << yellow << "* Incremental Defragmentation Tests" << reset << std::endl;
+		destroyedCount = 0;
+		for (size_t count = 0; count < (TEST_COUNT / 4); ++count)
+		{
+			const size_t idx = accessDist(gen);
+			const Entity entity = entities.at(idx);
+			if (entity != INVALID_ENTITY_HANDLE)
+			{
+				componentArchive.Destroy(entity);
+				entities.at(idx) = INVALID_ENTITY_HANDLE;
+				++destroyedCount;
+			}
+		}
+		std::cout << "** Num of destroyed entities -> " << red << destroyedCount << reset << std::endl;
+
+		constexpr auto defragmentationBudget = std::chrono::microseconds(1000);
+		size_t numOfDefragmentationSteps = 0;
+		size_t numOfDefragmentedEntities = 0;
+		size_t freedBytes = 0;
+		std::chrono::microseconds longestStepTime{ 0 };
+		ComponentArchive::DefragmentationStepResult stepResult;
+		do
+		{
+			begin = std::chrono::steady_clock::now();
+			stepResult = componentArchive.DefragmentStep(defragmentationBudget);
+			end = std::chrono::steady_clock::now();
+			longestStepTime = std::max(longestStepTime, std::chrono::duration_cast<std::chrono::microseconds>(end - begin));
+			numOfDefragmentedEntities += stepResult.NumOfMovedEntities;
+			freedBytes += stepResult.FreedBytes;
+			++numOfDefragmentationSteps;
+		} while (!stepResult.bIsCompleted);
+		std::cout << "** Defragmentation takes " << green << numOfDefragmentationSteps << reset << " steps of " << defragmentationBudget.count() << " us budget, longest step takes " << green << longestStepTime.count() << reset << " us" << std::endl;
+		std::cout << "** Moved entities -> " << green << numOfDefragmentedEntities << reset << ", Freed up Chunks Memory -> " << green << (freedBytes / 1024.0 / 1024.0) << reset << " MB" << std::endl;
+
+		elapsedTime = LinearDataValidation(componentArchive, entities, referenceVisible, referenceHittable, referenceInvisible);
+		std::cout << "** Incremental Defragmentation - Linear Access & Validation takes " << green << elapsedTime.count() << reset << " ms" << std::endl;
+
+		elapsedTime = RandomDataValidation(componentArchive, entities, referenceVisible, referenceHittable, referenceInvisible);
+		std::cout << "** Incremental Defragmentation - Random Access & Validation takes " << green << elapsedTime.count() << reset << " ms" << std::endl;
+
+		std::erase_if(disabledEntities, [&componentArchive](const Entity entity) { return !componentArchive.Contains<Invisible>(entity); });
+		bIsEnabledStateValid = ValidateEnabledInvisibles(componentArchive, entities, disabledEntities);
+		assert(bIsEnabledStateValid);
+		std::cout << "** Enabled state survives incremental defragmentation : " << (bIsEnabledStateValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/******************************************************************/
+		/* Shared component tests (entities which share equal value are grouped into same chunks) */
+		std::cout << std::endl << std::endl << yellow << "* Shared Component Tests" << reset << std::endl;
+		constexpr uint32_t numOfLODLevels = 4;
+		constexpr size_t numOfSharingEntities = TEST_COUNT / 10;
+		std::vector<Entity> sharingEntities;
+		sharingEntities.reserve(numOfSharingEntities);
+		begin = std::chrono::steady_clock::now();
+		for (size_t count = 0; count < numOfSharingEntities; ++count)
+		{
+			const Entity entity = GenerateEntity();
+			LODConfig lodConfig;
+			lodConfig.Level = static_cast<uint32_t>(count % numOfLODLevels);
+			componentArchive.SetShared(entity, lodConfig);
+			componentArchive.Attach<Hittable>(entity);
+			++hittableAllocCount;
+			sharingEntities.emplace_back(entity);
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "** Generation takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms, distinct values -> " << green << componentArchive.NumOfSharedValues<LODConfig>() << reset << std::endl;
+		std::cout << "** Saved data (estimation) -> " << green << ((numOfSharingEntities - numOfLODLevels) * sizeof(LODConfig) / 1024.0 / 1024.0) << reset << " MB" << std::endl;
+		assert(componentArchive.NumOfSharedValues<LODConfig>() == numOfLODLevels);
+
+		bool bIsSharingValid = true;
+		for (uint32_t level = 0; level < numOfLODLevels; ++level)
+		{
+			LODConfig lodConfig;
+			lodConfig.Level = level;
+			size_t numOfSharingRows = 0;
+			componentArchive.ForEachChunkSharing<LODConfig, Hittable>(lodConfig, [&numOfSharingRows, &bIsSharingValid, &componentArchive, level](const ChunkView& chunkView)
+				{
+					bIsSharingValid = bIsSharingValid && chunkView.Shared<LODConfig>()->Level == level;
+					for (const Entity entity : chunkView.Entities())
+					{
+						if (entity != INVALID_ENTITY_HANDLE)
+						{
+							bIsSharingValid = bIsSharingValid && componentArchive.GetShared<LODConfig>(entity) == chunkView.Shared<LODConfig>();
+							++numOfSharingRows;
+						}
+					}
+				});
+
+			bIsSharingValid = bIsSharingValid && numOfSharingRows == (numOfSharingEntities / numOfLODLevels);
+		}
+		assert(bIsSharingValid);
+		std::cout << "** Chunks are grouped by shared value : " << (bIsSharingValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Moving every entities to single value releases other values. */
+		for (const Entity entity : sharingEntities)
+		{
+			componentArchive.SetShared(entity, LODConfig());
+		}
+		assert(componentArchive.NumOfSharedValues<LODConfig>() == 1);
+		for (size_t idx = 0; idx < sharingEntities.size(); idx += 2)
+		{
+			componentArchive.Detach<LODConfig>(sharingEntities[idx]);
+		}
+		assert(!componentArchive.Contains<LODConfig>(sharingEntities.front()));
+		assert(componentArchive.Contains<Hittable>(sharingEntities.front()));
+		for (const Entity entity : sharingEntities)
+		{
+			componentArchive.Destroy(entity);
+		}
+		const bool bAreSharedValuesReleased = componentArchive.NumOfSharedValues<LODConfig>() == 0;
+		assert(bAreSharedValuesReleased);
+		std::cout << "** Shared values are released with last entity : " << (bAreSharedValuesReleased ? green + "True" : red + "False") << reset << std::endl;
+
+		/******************************************************************/
+		/* Field split component tests (declared fields are stored as SoA sub-columns) */
+		std::cout << std::endl << std::endl << yellow << "* Field Split Component Tests" << reset << std::endl;
+		constexpr size_t numOfParticles = TEST_COUNT / 2;
+		constexpr size_t numOfIntegrations = 20;
+		constexpr float deltaTime = 0.016f;
+		std::vector<Entity> particleEntities;
+		particleEntities.reserve(numOfParticles * 2);
+		for (size_t count = 0; count < numOfParticles; ++count)
+		{
+			const Entity wholeEntity = GenerateEntity();
+			componentArchive.Attach<WholeParticle>(wholeEntity);
+			componentArchive.GetMut<WholeParticle>(wholeEntity)->VelocityX = static_cast<float>(count % 7);
+			particleEntities.emplace_back(wholeEntity);
+
+			const Entity splitEntity = GenerateEntity();
+			componentArchive.Attach<Particle>(splitEntity);
+			*componentArchive.GetFieldMut<&Particle::VelocityX>(splitEntity) = static_cast<float>(count % 7);
+			particleEntities.emplace_back(splitEntity);
+		}
+
+		begin = std::chrono::steady_clock::now();
+		for (size_t integration = 0; integration < numOfIntegrations; ++integration)
+		{
+			componentArchive.ForEachChunk<WholeParticle>([deltaTime](ChunkView& chunkView)
+				{
+					WholeParticle* particles = chunkView.ColumnMut<WholeParticle>();
+					const size_t numOfRows = chunkView.Entities().size();
+					for (size_t row = 0; row < numOfRows; ++row)
+					{
+						particles[row].PositionX += particles[row].VelocityX * deltaTime;
+					}
+				});
+		}
+		end = std::chrono::steady_clock::now();
+		const auto wholeElapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+		std::cout << "** Whole component column integration takes " << green << wholeElapsedTime.count() << reset << " us" << std::endl;
+
+		begin = std::chrono::steady_clock::now();
+		for (size_t integration = 0; integration < numOfIntegrations; ++integration)
+		{
+			componentArchive.ForEachChunk<Particle>([deltaTime](ChunkView& chunkView)
+				{
+					const std::span<float> positions = chunkView.FieldMut<&Particle::PositionX>();
+					const std::span<const float> velocities = chunkView.Field<&Particle::VelocityX>();
+					for (size_t row = 0; row < positions.size(); ++row)
+					{
+						positions[row] += velocities[row] * deltaTime;
+					}
+				});
+		}
+		end = std::chrono::steady_clock::now();
+		const auto splitElapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+		std::cout << "** Field sub-column integration takes " << green << splitElapsedTime.count() << reset << " us" << std::endl;
+
+		/** Attach other component to move particles between archetypes, fields must follow rows. */
+		bool bAreFieldsValid = true;
+		for (size_t idx = 1; idx < particleEntities.size(); idx += 6)
+		{
+			componentArchive.Attach<Hittable>(particleEntities[idx]);
+			++hittableAllocCount;
+		}
+		for (size_t idx = 0; idx < particleEntities.size(); idx += 2)
+		{
+			const WholeParticle* wholeParticle = componentArchive.Get<WholeParticle>(particleEntities[idx]);
+			const float* position = componentArchive.GetField<&Particle::PositionX>(particleEntities[idx + 1]);
+			const float* mass = componentArchive.GetField<&Particle::Mass>(particleEntities[idx + 1]);
+			bAreFieldsValid = bAreFieldsValid && position != nullptr && *position == wholeParticle->PositionX && *mass == wholeParticle->Mass;
+		}
+		assert(bAreFieldsValid);
+		std::cout << "** Fields are same as whole component after archetype moves : " << (bAreFieldsValid ? green + "True" : red + "False") << reset << std::endl;
+
+		for (const Entity entity : particleEntities)
+		{
+			componentArchive.Destroy(entity);
+		}
+
+		/******************************************************************/
+		/* Tag component tests (tag has no column, tag only entity has no chunk allocation) */
+		std::cout << std::endl << std::endl << yellow << "* Tag Component Tests" << reset << std::endl;
+		const ChunkList hittableChunkList{ componentArchive.ReferenceChunkAllocator(), { ComponentInfo::Generate<Hittable>() } };
+		const ChunkList taggedChunkList{ componentArchive.ReferenceChunkAllocator(), { ComponentInfo::Generate<Hittable>(), ComponentInfo::Generate<Tag>() } };
+		const bool bIsTagFree = taggedChunkList.MaxNumOfAllocationsPerChunk() == hittableChunkList.MaxNumOfAllocationsPerChunk();
+		assert(bIsTagFree);
+		std::cout << "** Tag does not cost any row : " << (bIsTagFree ? green + "True" : red + "False") << reset << std::endl;
+
+		constexpr size_t numOfTaggedEntities = TEST_COUNT / 10;
+		std::vector<Entity> taggedEntities;
+		taggedEntities.reserve(numOfTaggedEntities);
+		const auto statisticsBeforeTagging = componentArchive.ReferenceChunkAllocator().QueryStatistics();
+		begin = std::chrono::steady_clock::now();
+		for (size_t count = 0; count < numOfTaggedEntities; ++count)
+		{
+			const Entity entity = GenerateEntity();
+			componentArchive.Attach<Tag>(entity);
+			taggedEntities.emplace_back(entity);
+		}
+		end = std::chrono::steady_clock::now();
+		const auto statisticsAfterTagging = componentArchive.ReferenceChunkAllocator().QueryStatistics();
+		std::cout << "** Tagging takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+		const bool bHasNoChunkAllocation = (statisticsBeforeTagging.Hits + statisticsBeforeTagging.Misses) == (statisticsAfterTagging.Hits + statisticsAfterTagging.Misses);
+		assert(bHasNoChunkAllocation);
+		std::cout << "** Tag only entities do not allocate chunk : " << (bHasNoChunkAllocation ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Tagged entity which has data lives in chunk of tag + data archetype. */
+		for (size_t idx = 0; idx < taggedEntities.size(); idx += 2)
+		{
+			componentArchive.Attach<Hittable>(taggedEntities[idx]);
+			++hittableAllocCount;
+		}
+		size_t numOfTaggedRows = 0;
+		componentArchive.ForEachChunk<Tag, Hittable>([&numOfTaggedRows](const ChunkView& chunkView)
+			{
+				numOfTaggedRows += std::ranges::count_if(chunkView.Entities(), [](const Entity entity) { return entity != INVALID_ENTITY_HANDLE; });
+			});
+		bool bIsTagQueryValid = numOfTaggedRows == (numOfTaggedEntities / 2);
+		bIsTagQueryValid = bIsTagQueryValid && Filter::All<Tag>(componentArchive, taggedEntities).size() == numOfTaggedEntities;
+		bIsTagQueryValid = bIsTagQueryValid && Filter::All<Tag, Hittable>(componentArchive, taggedEntities).size() == (numOfTaggedEntities / 2);
+		bIsTagQueryValid = bIsTagQueryValid && Filter::None<Hittable>(componentArchive, taggedEntities).size() == (numOfTaggedEntities / 2);
+
+		/** Detaching data goes back to tag only archetype, detaching tag keeps data. */
+		for (size_t idx = 0; idx < taggedEntities.size(); idx += 4)
+		{
+			componentArchive.Detach<Hittable>(taggedEntities[idx]);
+			componentArchive.Detach<Tag>(taggedEntities[idx + 2]);
+		}
+		bIsTagQueryValid = bIsTagQueryValid && componentArchive.Contains<Tag>(taggedEntities[0]) && !componentArchive.Contains<Hittable>(taggedEntities[0]);
+		bIsTagQueryValid = bIsTagQueryValid && !componentArchive.Contains<Tag>(taggedEntities[2]) && componentArchive.Get<Hittable>(taggedEntities[2]) != nullptr;
+		bIsTagQueryValid = bIsTagQueryValid && Filter::All<Tag>(componentArchive, taggedEntities).size() == (numOfTaggedEntities - (numOfTaggedEntities / 4));
+		assert(bIsTagQueryValid);
+		std::cout << "** Queries and filters match tag : " << (bIsTagQueryValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/******************************************************************/
+		/* Archetype signature tests (archetypes are found through hash of component ID bitset) */
+		std::cout << std::endl << std::endl << yellow << "* Archetype Signature Tests" << reset << std::endl;
+		const ArchetypeSignature signature = ArchetypeSignature(Archetype{ QueryComponentID<Visible>(), QueryComponentID<Hittable>() })
+			.With(QueryComponentID<Tag>())
+			.Without(QueryComponentID<Visible>());
+		const ArchetypeSignature expectedSignature{ Archetype{ QueryComponentID<Hittable>(), QueryComponentID<Tag>() } };
+		bool bIsSignatureValid = signature == expectedSignature && signature.Hash() == expectedSignature.Hash();
+		bIsSignatureValid = bIsSignatureValid && signature.Contains(QueryComponentID<Tag>()) && !signature.Contains(QueryComponentID<Visible>());
+		bIsSignatureValid = bIsSignatureValid && signature.Includes({ QueryComponentID<Hittable>() }) && signature.ToArchetype() == expectedSignature.ToArchetype();
+		assert(bIsSignatureValid);
+		std::cout << "** Signature is independent of order of changes : " << (bIsSignatureValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Component IDs are dense indices of registry, stable hash of type name finds same ID. */
+		const std::array<ComponentID, 5> componentIDs = { QueryComponentID<Visible>(), QueryComponentID<Hittable>(), QueryComponentID<Invisible>(), QueryComponentID<Tag>(), QueryComponentID<LODConfig>() };
+		bool bIsComponentIDDense = std::all_of(componentIDs.cbegin(), componentIDs.cend(), [](const ComponentID componentID) { return componentID < ComponentRegistry::NumOfComponents(); });
+		bIsComponentIDDense = bIsComponentIDDense && ComponentRegistry::NumOfComponents() <= MAX_NUM_OF_COMPONENTS;
+		bIsComponentIDDense = bIsComponentIDDense && ComponentRegistry::FindComponentID(QueryComponentHash<Hittable>()) == QueryComponentID<Hittable>();
+		bIsComponentIDDense = bIsComponentIDDense && QueryComponentHash<Visible>() != QueryComponentHash<Invisible>();
+		assert(bIsComponentIDDense);
+		std::cout << "** Component IDs are dense and found by hash : " << (bIsComponentIDDense ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Component does not need base class, so rows only hold members of component. */
+		static_assert(std::is_trivially_copyable_v<Velocity> && sizeof(Invisible) == sizeof(uint64_t));
+		const Entity plainDataEntity = GenerateEntity();
+		componentArchive.Attach<Velocity>(plainDataEntity, Velocity{ .X = 1.0f, .Y = 2.0f, .Z = 3.0f });
+		componentArchive.Attach<Invisible>(plainDataEntity);
+		++invisibleAllocCount;
+		const Velocity* velocity = componentArchive.Get<Velocity>(plainDataEntity);
+		const bool bIsPlainDataComponentValid = velocity != nullptr && velocity->X == 1.0f && velocity->Z == 3.0f && componentArchive.Get<Invisible>(plainDataEntity)->Duration == 186;
+		componentArchive.Destroy(plainDataEntity);
+		assert(bIsPlainDataComponentValid);
+		std::cout << "** Plain data component without base class : " << (bIsPlainDataComponentValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Tag has no column, so moving row between Hittable and Hittable + Tag copies only Hittable column. */
+		const ChunkList::TransferPlan transferPlan = ChunkList::BuildTransferPlan(hittableChunkList, taggedChunkList);
+		const bool bIsTransferPlanValid = transferPlan.Columns.size() == 1 && transferPlan.Columns.front().Size == sizeof(Hittable) && transferPlan.EnabledMasks.empty();
+		assert(bIsTransferPlanValid);
+		std::cout << "** Transfer plan pairs only common columns : " << (bIsTransferPlanValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Toggling tag moves entity between two archetypes through cached edges. */
+		constexpr size_t numOfToggles = 4;
+		begin = std::chrono::steady_clock::now();
+		for (size_t toggle = 0; toggle < numOfToggles; ++toggle)
+		{
+			for (size_t idx = 2; idx < taggedEntities.size(); idx += 4)
+			{
+				componentArchive.Attach<Tag>(taggedEntities[idx]);
+				componentArchive.Detach<Tag>(taggedEntities[idx]);
+			}
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "** Attach & Detach of " << green << (numOfToggles * 2 * (numOfTaggedEntities / 4)) << reset << " times takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		for (const Entity entity : taggedEntities)
+		{
+			componentArchive.Destroy(entity);
+		}
+
+		/******************************************************************/
+		/* Multi-component attach tests (several components attached through single archetype migration) */
+		std::cout << std::endl << std::endl << yellow << "* Multi-Component Attach Tests" << reset << std::endl;
+		constexpr size_t numOfMultiAttachEntities = TEST_COUNT / 10;
+		std::vector<Entity> singleAttachedEntities(numOfMultiAttachEntities);
+		std::vector<Entity> multiAttachedEntities(numOfMultiAttachEntities);
+		std::generate(singleAttachedEntities.begin(), singleAttachedEntities.end(), GenerateEntity);
+		std::generate(multiAttachedEntities.begin(), multiAttachedEntities.end(), GenerateEntity);
+
+		begin = std::chrono::steady_clock::now();
+		for (const Entity entity : singleAttachedEntities)
+		{
+			componentArchive.Attach<Visible>(entity);
+			componentArchive.Attach<Hittable>(entity);
+			componentArchive.Attach<Invisible>(entity);
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "** Attach 3 components one by one to " << green << numOfMultiAttachEntities << reset << " entities takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		begin = std::chrono::steady_clock::now();
+		for (const Entity entity : multiAttachedEntities)
+		{
+			componentArchive.Attach<Visible, Hittable, Invisible>(entity);
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "** Attach 3 components at once to " << green << numOfMultiAttachEntities << reset << " entities takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+		visibleAllocCount += numOfMultiAttachEntities * 2;
+		hittableAllocCount += numOfMultiAttachEntities * 2;
+		invisibleAllocCount += numOfMultiAttachEntities * 2;
+
+		bool bIsMultiAttachValid = componentArchive.QueryArchetype(multiAttachedEntities.front()) == componentArchive.QueryArchetype(singleAttachedEntities.front());
+		bIsMultiAttachValid = bIsMultiAttachValid && Filter::All<Visible, Hittable, Invisible>(componentArchive, multiAttachedEntities).size() == numOfMultiAttachEntities;
+		bIsMultiAttachValid = bIsMultiAttachValid && componentArchive.Get<Hittable>(multiAttachedEntities.back())->HitCount == Hittable().HitCount;
+		++hittableAllocCount;
+		/** Attach fails as whole if entity already has any of given components. */
+		bIsMultiAttachValid = bIsMultiAttachValid && !componentArchive.Attach<Tag, Visible>(multiAttachedEntities.front()) && !componentArchive.Contains<Tag>(multiAttachedEntities.front());
+
+		const Entity particleEntity = GenerateEntity();
+		WholeParticle wholeParticle;
+		wholeParticle.Mass = 4.0f;
+		Particle particle;
+		particle.Lifetime = 2.0f;
+		bIsMultiAttachValid = bIsMultiAttachValid && componentArchive.Attach(particleEntity, Tag(), std::move(wholeParticle), std::move(particle));
+		bIsMultiAttachValid = bIsMultiAttachValid && componentArchive.Contains<Tag>(particleEntity) && componentArchive.Get<WholeParticle>(particleEntity)->Mass == 4.0f;
+		bIsMultiAttachValid = bIsMultiAttachValid && *componentArchive.GetField<&Particle::Lifetime>(particleEntity) == 2.0f;
+		assert(bIsMultiAttachValid);
+		std::cout << "** Multi-component attach reaches same archetype with constructed components : " << (bIsMultiAttachValid ? green + "True" : red + "False") << reset << std::endl;
+
+		componentArchive.Destroy(particleEntity);
+		for (size_t idx = 0; idx < numOfMultiAttachEntities; ++idx)
+		{
+			componentArchive.Destroy(singleAttachedEntities[idx]);
+			componentArchive.Destroy(multiAttachedEntities[idx]);
+		}
+
+		/******************************************************************/
+		/* Bulk spawn tests (entities are spawned directly into their archetype, chunk by chunk) */
+		std::cout << std::endl << std::endl << yellow << "* Bulk Spawn Tests" << reset << std::endl;
+		constexpr size_t numOfSpawnedEntities = TEST_COUNT;
+		begin = std::chrono::steady_clock::now();
+		const std::vector<Entity> spawnedEntities = componentArchive.Spawn<Hittable, Invisible, Tag>(numOfSpawnedEntities,
+			[](const size_t idx, Hittable& hittable, Invisible& invisible, Tag&)
+			{
+				hittable.HitCount = idx;
+				invisible.Duration = idx * 2;
+			});
+		end = std::chrono::steady_clock::now();
+		hittableAllocCount += numOfSpawnedEntities;
+		invisibleAllocCount += numOfSpawnedEntities;
+		std::cout << "** Spawn " << green << numOfSpawnedEntities << reset << " entities takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		bool bIsSpawnValid = spawnedEntities.size() == numOfSpawnedEntities;
+		bIsSpawnValid = bIsSpawnValid && componentArchive.QueryArchetype(spawnedEntities.front()) == Archetype{ QueryComponentID<Hittable>(), QueryComponentID<Invisible>(), QueryComponentID<Tag>() };
+		for (size_t idx = 0; idx < spawnedEntities.size() && bIsSpawnValid; idx += 997)
+		{
+			bIsSpawnValid = componentArchive.Get<Hittable>(spawnedEntities[idx])->HitCount == idx && componentArchive.Get<Invisible>(spawnedEntities[idx])->Duration == idx * 2;
+			bIsSpawnValid = bIsSpawnValid && componentArchive.IsEnabled<Invisible>(spawnedEntities[idx]);
+		}
+		assert(bIsSpawnValid);
+		std::cout << "** Spawned entities are initialized in their archetype : " << (bIsSpawnValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Spawn fills holes of existing chunks before creating new chunks. */
+		constexpr size_t numOfRespawnedEntities = 1000;
+		for (size_t idx = 0; idx < numOfRespawnedEntities * 2; idx += 2)
+		{
+			componentArchive.Destroy(spawnedEntities[idx]);
+		}
+		const std::vector<Entity> respawnedEntities = componentArchive.Spawn<Hittable, Invisible, Tag>(numOfRespawnedEntities,
+			[](const size_t idx, Hittable& hittable, Invisible&, Tag&)
+			{
+				hittable.HitCount = ~idx;
+			});
+		hittableAllocCount += numOfRespawnedEntities;
+		invisibleAllocCount += numOfRespawnedEntities;
+		bool bIsRespawnValid = true;
+		for (size_t idx = 0; idx < numOfRespawnedEntities; ++idx)
+		{
+			bIsRespawnValid = bIsRespawnValid && componentArchive.Get<Hittable>(respawnedEntities[idx])->HitCount == ~idx;
+			bIsRespawnValid = bIsRespawnValid && componentArchive.Get<Hittable>(spawnedEntities[(idx * 2) + 1])->HitCount == (idx * 2) + 1;
+		}
+		assert(bIsRespawnValid);
+		std::cout << "** Spawn fills free rows of existing chunks : " << (bIsRespawnValid ? green + "True" : red + "False") << reset << std::endl;
+
+		for (size_t idx = 1; idx < spawnedEntities.size(); idx += (idx < numOfRespawnedEntities * 2) ? 2 : 1)
+		{
+			componentArchive.Destroy(spawnedEntities[idx]);
+		}
+
+		for (const Entity entity : respawnedEntities)
+		{
+			componentArchive.Destroy(entity);
+		}
+
+		/******************************************************************/
+		/* Bulk structural change tests (whole archetypes change at once instead of entity by entity) */
+		std::cout << std::endl << std::endl << yellow << "* Bulk Structural Change Tests" << reset << std::endl;
+		constexpr size_t numOfBulkEntities = TEST_COUNT;
+		const Archetype bulkFilter{ QueryComponentID<Hittable>(), QueryComponentID<Tag>() };
+		std::vector<Entity> perEntityEntities = componentArchive.Spawn<Hittable, Tag>(numOfBulkEntities);
+		hittableAllocCount += numOfBulkEntities;
+		begin = std::chrono::steady_clock::now();
+		for (const Entity entity : perEntityEntities)
+		{
+			componentArchive.Attach<Visible>(entity);
+		}
+		end = std::chrono::steady_clock::now();
+		visibleAllocCount += numOfBulkEntities;
+		std::cout << "** Attach to " << green << numOfBulkEntities << reset << " entities one by one takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+		for (const Entity entity : perEntityEntities)
+		{
+			componentArchive.Destroy(entity);
+		}
+
+		const std::vector<Entity> bulkEntities = componentArchive.Spawn<Hittable, Tag>(numOfBulkEntities,
+			[](const size_t idx, Hittable& hittable, Tag&)
+			{
+				hittable.HitCount = idx;
+			});
+		hittableAllocCount += numOfBulkEntities;
+		begin = std::chrono::steady_clock::now();
+		const size_t numOfAttachedEntities = componentArchive.AttachAll<Visible>(bulkFilter);
+		end = std::chrono::steady_clock::now();
+		visibleAllocCount += numOfAttachedEntities;
+		std::cout << "** AttachAll to " << green << numOfAttachedEntities << reset << " entities takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+
+		bool bIsBulkAttachValid = numOfAttachedEntities >= numOfBulkEntities;
+		for (size_t idx = 0; idx < bulkEntities.size() && bIsBulkAttachValid; idx += 997)
+		{
+			bIsBulkAttachValid = componentArchive.Contains<Visible>(bulkEntities[idx]) && componentArchive.Get<Hittable>(bulkEntities[idx])->HitCount == idx;
+		}
+		assert(bIsBulkAttachValid);
+		std::cout << "** AttachAll moves every matching entities with their components : " << (bIsBulkAttachValid ? green + "True" : red + "False") << reset << std::endl;
+
+		const size_t numOfDetachedEntities = componentArchive.DetachAll<Hittable>(Archetype{ QueryComponentID<Visible>(), QueryComponentID<Tag>() });
+		bool bIsBulkDetachValid = numOfDetachedEntities >= numOfBulkEntities;
+		for (size_t idx = 0; idx < bulkEntities.size() && bIsBulkDetachValid; idx += 997)
+		{
+			bIsBulkDetachValid = !componentArchive.Contains<Hittable>(bulkEntities[idx]) && componentArchive.Contains<Visible>(bulkEntities[idx]) && componentArchive.Contains<Tag>(bulkEntities[idx]);
+		}
+		assert(bIsBulkDetachValid);
+		std::cout << "** DetachAll destroys and removes component from every matching entities : " << (bIsBulkDetachValid ? green + "True" : red + "False") << reset << std::endl;
+
+		begin = std::chrono::steady_clock::now();
+		const size_t numOfBulkDestroyedEntities = componentArchive.DestroyAll<Visible, Tag>();
+		end = std::chrono::steady_clock::now();
+		std::cout << "** DestroyAll " << green << numOfBulkDestroyedEntities << reset << " entities takes " << green << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << reset << " ms" << std::endl;
+		const bool bIsBulkDestroyValid = numOfBulkDestroyedEntities >= numOfBulkEntities && componentArchive.QueryArchetype(bulkEntities.front()).empty() && componentArchive.QueryArchetype(bulkEntities.back()).empty();
+		assert(bIsBulkDestroyValid);
+		std::cout << "** DestroyAll removes every matching entities : " << (bIsBulkDestroyValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Tag only archetype has no storage so its chunk list keeps entities instead of rows, entity without any component is never matched. */
+		const Entity componentlessEntity = GenerateEntity();
+		const std::vector<Entity> tagOnlyEntities = componentArchive.Spawn<Tag>(numOfBulkEntities / 10);
+		componentArchive.Destroy(tagOnlyEntities.front());
+		const size_t numOfDetachedTags = componentArchive.DetachAll<Tag>();
+		bool bIsTagOnlyBulkValid = numOfDetachedTags >= (tagOnlyEntities.size() - 1) && !componentArchive.Contains<Tag>(tagOnlyEntities.back());
+		componentArchive.Attach<Tag>(tagOnlyEntities.back());
+		componentArchive.DestroyAll<>();
+		bIsTagOnlyBulkValid = bIsTagOnlyBulkValid && !componentArchive.IsAlive(tagOnlyEntities.back()) && componentArchive.IsAlive(tagOnlyEntities[1]) && componentArchive.IsAlive(componentlessEntity);
+		assert(bIsTagOnlyBulkValid);
+		std::cout << "** Bulk operations visit tag only archetype and skip entities without component : " << (bIsTagOnlyBulkValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/******************************************************************/
+		/* Entity handle tests (handle is index of entity record + generation of that record) */
+		std::cout << std::endl << std::endl << yellow << "* Entity Handle Tests" << reset << std::endl;
+		const Entity destroyedEntity = GenerateEntity();
+		componentArchive.Attach<Hittable>(destroyedEntity);
+		componentArchive.Destroy(destroyedEntity);
+		const Entity recycledEntity = GenerateEntity();
+		bool bIsEntityHandleValid = !componentArchive.IsAlive(destroyedEntity) && componentArchive.IsAlive(recycledEntity);
+		bIsEntityHandleValid = bIsEntityHandleValid && IndexOf(recycledEntity) == IndexOf(destroyedEntity) && GenerationOf(recycledEntity) == GenerationOf(destroyedEntity) + 1;
+		bIsEntityHandleValid = bIsEntityHandleValid && componentArchive.Attach<Hittable>(recycledEntity) && !componentArchive.Attach<Hittable>(destroyedEntity);
+		bIsEntityHandleValid = bIsEntityHandleValid && componentArchive.Get<Hittable>(destroyedEntity) == nullptr && componentArchive.Get<Hittable>(recycledEntity) != nullptr;
+		hittableAllocCount += 2;
+		componentArchive.Destroy(destroyedEntity);
+		bIsEntityHandleValid = bIsEntityHandleValid && componentArchive.Contains<Hittable>(recycledEntity);
+		componentArchive.Destroy(recycledEntity);
+		/** Handle which is pooled for reuse is not alive until it is issued again. */
+		bIsEntityHandleValid = bIsEntityHandleValid && !componentArchive.IsAlive(MakeEntity(IndexOf(recycledEntity), GenerationOf(recycledEntity) + 1));
+		assert(bIsEntityHandleValid);
+		std::cout << "** Stale handle is rejected and its index is recycled with next generation : " << (bIsEntityHandleValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/**
+		* Each thread creates entities from its own reservation block, so threads do not contend on single counter.
+		* Loaders start together behind latch, and each of them refills its reservation block many times.
+		*/
+		constexpr size_t numOfEntitiesPerLoader = TEST_COUNT / 4;
+		static_assert(numOfEntitiesPerLoader >= ComponentArchive::ENTITY_RESERVATION_BLOCK_SIZE * 8);
+		bool bIsConcurrentCreationValid = true;
+		double singleLoaderThroughput = 0.0;
+		for (const size_t numOfLoaders : { size_t(1), size_t(4) })
+		{
+			std::vector<std::vector<Entity>> loadedEntities(numOfLoaders, std::vector<Entity>(numOfEntitiesPerLoader));
+			std::vector<std::thread> loaders;
+			std::latch startLatch{ static_cast<std::ptrdiff_t>(numOfLoaders + 1) };
+			for (size_t loaderIndex = 0; loaderIndex < numOfLoaders; ++loaderIndex)
+			{
+				loaders.emplace_back([&loadedEntities, &startLatch, loaderIndex]()
+					{
+						startLatch.arrive_and_wait();
+						std::generate(loadedEntities[loaderIndex].begin(), loadedEntities[loaderIndex].end(), GenerateEntity);
+					});
+			}
+
+			startLatch.arrive_and_wait();
+			begin = std::chrono::steady_clock::now();
+			for (std::thread& loader : loaders)
+			{
+				loader.join();
+			}
+			end = std::chrono::steady_clock::now();
+			const double elapsedMs = std::max(std::chrono::duration<double, std::milli>(end - begin).count(), 0.001);
+			const double throughput = (numOfLoaders * numOfEntitiesPerLoader) / elapsedMs;
+			singleLoaderThroughput = numOfLoaders == 1 ? throughput : singleLoaderThroughput;
+			std::cout << "** " << green << numOfLoaders << reset << " thread(s) create " << green << (numOfLoaders * numOfEntitiesPerLoader) << reset << " entities, takes " << green << elapsedMs << reset << " ms ("
+				<< green << throughput << reset << " entities/ms, " << green << (throughput / singleLoaderThroughput) << reset << "x of single thread)" << std::endl;
+
+			std::vector<Entity> allLoadedEntities;
+			for (const std::vector<Entity>& entities : loadedEntities)
+			{
+				allLoadedEntities.insert(allLoadedEntities.end(), entities.cbegin(), entities.cend());
+			}
+
+			std::sort(allLoadedEntities.begin(), allLoadedEntities.end());
+			bIsConcurrentCreationValid = bIsConcurrentCreationValid && std::adjacent_find(allLoadedEntities.cbegin(), allLoadedEntities.cend()) == allLoadedEntities.cend();
+			bIsConcurrentCreationValid = bIsConcurrentCreationValid && std::all_of(allLoadedEntities.cbegin(), allLoadedEntities.cend(), [&componentArchive](const Entity entity) { return componentArchive.IsAlive(entity); });
+		}
+		assert(bIsConcurrentCreationValid);
+		std::cout << "** Concurrently created entities are unique : " << (bIsConcurrentCreationValid ? green + "True" : red + "False") << reset << std::endl;
+
+		/** Handles which short lived threads destroyed one by one or all at once, must be returned to global pool and reused by other thread. */
+		constexpr size_t numOfRecycledPerThread = ComponentArchive::ENTITY_RESERVATION_BLOCK_SIZE * 5;
+		const size_t numOfPooledBeforeRecycle = componentArchive.NumOfPooledEntities();
+		std::thread([&componentArchive]()
+			{
+				for (const Entity entity : componentArchive.Spawn<Invisible>(numOfRecycledPerThread))
+				{
+					componentArchive.Destroy(entity);
+				}
+			}).join();
+		std::thread([&componentArchive]()
+			{
+				componentArchive.Spawn<Invisible>(numOfRecycledPerThread);
+				componentArchive.DestroyAll<Invisible>();
+			}).join();
+		invisibleAllocCount += numOfRecycledPerThread * 2;
+
+		Entity reusedEntity = INVALID_ENTITY_HANDLE;
+		std::thread([&reusedEntity]() { reusedEntity = GenerateEntity(); }).join();
+		const bool bIsRecyclingAcrossThreadsValid = componentArchive.NumOfPooledEntities() + 1 >= numOfPooledBeforeRecycle + (numOfRecycledPerThread * 2) && GenerationOf(reusedEntity) > FIRST_ENTITY_GENERATION;
+		assert(bIsRecyclingAcrossThreadsValid);
+		std::cout << "** Handles destroyed by exited threads are reused by other thread : " << (bIsRecyclingAcrossThreadsValid ? green + "True" : red + "False") << reset << std::endl;
 	}
 
 	std::cout << std::endl << std::endl << yellow << "* RAII Validation" << reset << std::endl;
 	ComponentArchive::DestroyInstance();
 	std::cout << "** Num of actual generation (Visible Component) : " << visibleAllocCount << " (times)" << std::endl;
 	std::cout << "** Num of call constructor of (Visible Component) : " << Visible::Alloc << " (times)" << std::endl;
+	std::cout << "** Num of call move constructor of (Visible Component) : " << Visible::Moved << " (times)" << std::endl;
 	std::cout << "** Num of call destructor of (Visible Component) : " << Visible::Dealloc << " (times)" << std::endl;
 	assert(visibleAllocCount == Visible::Alloc);
-	assert(Visible::Alloc == Visible::Dealloc);
+	assert(Visible::Alloc + Visible::Moved == Visible::Dealloc);
 
 	std::cout << "** Num of actual generation (Hittable Component) : " << hittableAllocCount << " (times)" << std::endl;
 	std::cout << "** Num of call constructor of (Hittable Component) : " << Hittable::Alloc << " (times)" << std::endl;
+	std::cout << "** Num of call move constructor of (Hittable Component) : " << Hittable::Moved << " (times)" << std::endl;
 	std::cout << "** Num of call destructor of (Hittable Component) : " << Hittable::Dealloc << " (times)" << std::endl;
 	assert(hittableAllocCount == Hittable::Alloc);
-	assert(Hittable::Alloc == Hittable::Dealloc);
+	assert(Hittable::Alloc + Hittable::Moved == Hittable::Dealloc);
 
 	std::cout << "** Num of actual generation (Invisible Component) : " << invisibleAllocCount << " (times)" << std::endl;
 	std::cout << "** Num of call constructor of (Invisible Component) : " << Invisible::Alloc << " (times)" << std::endl;
+	std::cout << "** Num of call move constructor of (Invisible Component) : " << Invisible::Moved << " (times)" << std::endl;
 	std::cout << "** Num of call destructor of (Invisible Component) : " << Invisible::Dealloc << " (times)" << std::endl;
 	assert(invisibleAllocCount == Invisible::Alloc);
-	assert(Invisible::Alloc == Invisible::Dealloc);
+	assert(Invisible::Alloc + Invisible::Moved == Invisible::Dealloc);
 
 	/** Check Memory Leaks */
 	_CrtDumpMemoryLeaks();